@@ -0,0 +1,185 @@
+//
+//  Antialias.h
+//  CG
+//
+
+#ifndef Antialias_h
+#define Antialias_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Bresenham.h"
+#include "Rasterizer.h"
+
+// 结构数组形式的覆盖率输出：第 i 个像素为 (x[i], y[i])，覆盖率 alpha[i] 在 [0, 1]。
+// 各数组连续存放，逐元素的循环可以直接被编译器向量化
+struct Coverage {
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<float> alpha;
+
+    size_t size() const
+    {
+        return alpha.size();
+    }
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        alpha.clear();
+    }
+    void resize(size_t n)
+    {
+        x.resize(n);
+        y.resize(n);
+        alpha.resize(n);
+    }
+};
+
+// Wu 反走样直线的像素数：主方向每步两个像素，端点为整数所以不需要端点间隙处理
+inline size_t wuLineCount(const Segment& s)
+{
+    return 2 * ((size_t) bresenhamLineCount(s.x_start, s.y_start, s.x_end, s.y_end) + 1);
+}
+
+// 把一条线段写到 x / y / alpha 的 [0, 2n) 位置：前 n 个是下方像素，后 n 个是上方像素
+inline void wuLine(const Segment& s, int* xs, int* ys, float* alpha)
+{
+    int delta_x = s.x_end - s.x_start;
+    int delta_y = s.y_end - s.y_start;
+    // 斜率大于1，按 y 方向步进，x y 交换
+    bool rotate = std::abs(delta_y) > std::abs(delta_x);
+    int major_start = rotate ? s.y_start : s.x_start;
+    int minor_start = rotate ? s.x_start : s.y_start;
+    int major_delta = rotate ? delta_y : delta_x;
+    int minor_delta = rotate ? delta_x : delta_y;
+    int steps = std::abs(major_delta);
+    int direction = major_delta < 0 ? -1 : 1;
+    float gradient = steps == 0 ? 0.0f : (float) minor_delta / steps;
+    int* majors = rotate ? ys : xs;
+    int* minors = rotate ? xs : ys;
+    for(int i = 0; i <= steps; ++i)
+    {
+        float minor = minor_start + gradient * i;
+        float base = std::floor(minor);
+        float frac = minor - base;
+        int major = major_start + direction * i;
+        majors[i] = major;
+        minors[i] = (int) base;
+        alpha[i] = 1.0f - frac;
+        majors[steps + 1 + i] = major;
+        minors[steps + 1 + i] = (int) base + 1;
+        alpha[steps + 1 + i] = frac;
+    }
+}
+
+// 批量反走样画线，结果追加在 out 末尾；与 bresenhamLines 一样先一次性扩容，复用 out 时不再分配
+inline void wuLines(const Segment* segments, size_t count, Coverage& out)
+{
+    size_t total = 0;
+    for(size_t i = 0; i < count; ++i)
+        total += wuLineCount(segments[i]);
+    size_t offset = out.size();
+    out.resize(offset + total);
+    for(size_t i = 0; i < count; ++i)
+    {
+        wuLine(segments[i], out.x.data() + offset, out.y.data() + offset, out.alpha.data() + offset);
+        offset += wuLineCount(segments[i]);
+    }
+}
+
+inline void wuLines(const std::vector<Segment>& segments, Coverage& out)
+{
+    wuLines(segments.data(), segments.size(), out);
+}
+
+// 像素 (a, b)（0 <= a <= b）按八方向对称写出，坐标轴上和对角线上的像都只写一次，
+// 返回写出的个数。同一像素写两次会被 blendCoverage 混合两次，比应有的覆盖率更深
+inline int mirrorCoverage(int c_x, int c_y, int a, int b, float value, int* xs, int* ys, float* alpha)
+{
+    int n = 0;
+    auto put = [&](int x, int y)
+    {
+        xs[n] = c_x + x;
+        ys[n] = c_y + y;
+        alpha[n] = value;
+        ++n;
+    };
+    if(b == 0)
+    {
+        put(0, 0);
+        return n;
+    }
+    if(a == 0)
+    {
+        put(0, b);
+        put(0, -b);
+        put(b, 0);
+        put(-b, 0);
+        return n;
+    }
+    put(a, b);
+    put(-a, b);
+    put(a, -b);
+    put(-a, -b);
+    if(a == b)
+        return n;
+    put(b, a);
+    put(-b, a);
+    put(b, -a);
+    put(-b, -a);
+    return n;
+}
+
+// Wu 反走样圆：第一个八分圆（x <= y）每列求精确的 y，上下两个像素按小数部分分配覆盖率，再八方向对称。
+// 八分圆内 y >= x，所以每列的内侧像素至多落在对角线上，外侧像素总在对角线以上，
+// 对称后的像素两两不同
+inline void wuCircle(int c_x, int c_y, float r, Coverage& out)
+{
+    if(r <= 0.0f)
+        return;
+    int cnt = (int) std::floor(r / std::sqrt(2.0f)) + 1;
+    size_t offset = out.size();
+    out.resize(offset + 16 * cnt);
+    int* xs = out.x.data() + offset;
+    int* ys = out.y.data() + offset;
+    float* alpha = out.alpha.data() + offset;
+    size_t n = 0;
+    for(int i = 0; i < cnt; ++i)
+    {
+        float y = std::sqrt(r * r - (float) i * i);
+        float base = std::floor(y);
+        float frac = y - base;
+        int inner = std::max((int) base, i);
+        n += mirrorCoverage(c_x, c_y, i, inner, 1.0f - frac, xs + n, ys + n, alpha + n);
+        n += mirrorCoverage(c_x, c_y, i, inner + 1, frac, xs + n, ys + n, alpha + n);
+    }
+    out.resize(offset + n);
+}
+
+// 以 alpha 把 color 混合到帧缓冲，颜色按 0xAABBGGRR 的 4 个 8 位通道处理
+inline void blendCoverage(const Coverage& coverage, Framebuffer& fb, uint32_t color)
+{
+    for(size_t i = 0; i < coverage.size(); ++i)
+    {
+        int x = coverage.x[i] + fb.origin_x;
+        int y = coverage.y[i] + fb.origin_y;
+        if(x < 0 || x >= fb.width || y < 0 || y >= fb.height)
+            continue;
+        uint32_t& pixel = fb.pixels[(size_t) y * fb.width + x];
+        uint32_t a = (uint32_t) (coverage.alpha[i] * 256.0f + 0.5f);
+        uint32_t result = 0;
+        for(int shift = 0; shift < 32; shift += 8)
+        {
+            uint32_t src = (color >> shift) & 0xFF;
+            uint32_t dst = (pixel >> shift) & 0xFF;
+            result |= ((dst * (256 - a) + src * a) >> 8) << shift;
+        }
+        pixel = result;
+    }
+}
+
+#endif /* Antialias_h */
@@ -2,6 +2,8 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <vector>
+#include "Bresenham.h"
+#include "Clip.h"
 
 const uint SCR_WIDTH = 800;
 const uint SCR_HEIGHT = 600;
@@ -31,73 +33,6 @@ void processInput(GLFWwindow *window)
     glfwSetWindowShouldClose(window, true);
 }
 
-void swap(int& a, int& b)
-{
-    int c(std::move(a));
-    a = std::move(b);
-    b = std::move(c);
-}
-
-std::vector<int> bresenhamLine(int x_start, int y_start, int x_end, int y_end)
-{
-    int sign = 1;
-    int delta_x = x_end - x_start;
-    if(delta_x < 0)
-    {
-        delta_x *= -1;
-        swap(x_start, x_end);
-        swap(y_start, y_end);
-    }
-    int delta_y = y_end - y_start;
-    // 斜率为负，作y轴轴对称
-    if(delta_y < 0)
-    {
-        delta_y *= -1;
-        sign = -1;
-        swap(x_start, x_end);
-        swap(y_start, y_end);
-        x_start *= -1;
-        x_end *= -1;
-    }
-    bool rotate = false;
-    // 斜率大于1，x y交换
-    if(delta_y > delta_x)
-    {
-        swap(x_start, y_start);
-        swap(x_end, y_end);
-        swap(delta_x, delta_y);
-        rotate = true;
-    }
-    std::vector<int> coordinates_xy(2 * delta_x);
-    int p_i = 2 * delta_y - delta_x;
-    int y_last = y_start;
-    for(int i = 0; i < delta_x; ++i)
-    {
-        if(p_i <= 0)
-        p_i += 2 * delta_y;
-        else
-        {
-            ++y_last;
-            p_i += 2 * delta_y - 2 * delta_x;
-        }
-        coordinates_xy[2 * i] = rotate ? sign * y_last : sign * (x_start + i);
-        coordinates_xy[2 * i + 1] = rotate ? x_start + i : y_last;
-    }
-    return coordinates_xy;
-}
-
-float* normalize(std::vector<int> coordinates_xy, int cnt)
-{
-    float* coordinates = new float[3 * cnt];
-    for(int i = 0; i < cnt; ++i)
-    {
-        coordinates[3 * i] = (float)coordinates_xy[2 * i] / SCR_WIDTH;
-        coordinates[3 * i + 1] = (float)coordinates_xy[2 * i + 1] / SCR_HEIGHT;
-        coordinates[3 * i + 2] = 0.0f;
-    }
-    return coordinates;
-}
-
 int main()
 {
     glfwInit();
@@ -139,16 +74,21 @@ int main()
     int v3_x = 300;
     int v3_y = -500;
     
-    std::vector<int> coordinates_xy = bresenhamLine(v1_x, v1_y, v2_x, v2_y);
-    std::vector<int> line_23 = bresenhamLine(v2_x, v2_y, v3_x, v3_y);
-    coordinates_xy.insert(coordinates_xy.end(), line_23.begin(), line_23.end());
-    std::vector<int> line_31 = bresenhamLine(v3_x, v3_y, v1_x, v1_y);
-    coordinates_xy.insert(coordinates_xy.end(), line_31.begin(), line_31.end());
+    Segment segments[] = {
+        {v1_x, v1_y, v2_x, v2_y},
+        {v2_x, v2_y, v3_x, v3_y},
+        {v3_x, v3_y, v1_x, v1_y}
+    };
+    // 视口外的像素不生成，NDC 的 [-1, 1] 对应 [-SCR_WIDTH, SCR_WIDTH] x [-SCR_HEIGHT, SCR_HEIGHT]
+    Clipper clipper(ClipRect{-(int) SCR_WIDTH, -(int) SCR_HEIGHT, (int) SCR_WIDTH, (int) SCR_HEIGHT});
+    std::vector<int> coordinates_xy;
+    clipper.lines(segments, 3, coordinates_xy);
     
     int cnt = (int) coordinates_xy.size() / 2;
-    float* coordinates = normalize(coordinates_xy, cnt);
+    std::vector<float> coordinates;
+    normalize(coordinates_xy, coordinates, SCR_WIDTH, SCR_HEIGHT);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, 3 * cnt * sizeof(float), coordinates, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, 3 * cnt * sizeof(float), coordinates.data(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -219,7 +159,6 @@ int main()
     
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-    delete[] coordinates;
     
     glfwTerminate();
     return 0;
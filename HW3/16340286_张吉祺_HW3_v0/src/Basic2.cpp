@@ -3,6 +3,7 @@
 #include <iostream>
 #include <vector>
 #include <math.h>
+#include "Bresenham.h"
 
 const uint SCR_WIDTH = 800;
 const uint SCR_HEIGHT = 600;
@@ -32,61 +33,6 @@ void processInput(GLFWwindow *window)
     glfwSetWindowShouldClose(window, true);
 }
 
-std::vector<int> bresenhamCircle(int c_x, int c_y, int r)
-{
-    int cnt = r / sqrt(2);
-    std::vector<int> coordinates_xy(16 * cnt);
-    int x = 0;
-    int y = r;
-    int d_i = 3 - 2 * r;
-    coordinates_xy[0] = x;
-    coordinates_xy[1] = y;
-    for(int i = 1; i < cnt; ++i)
-    {
-        if(d_i <= 0)
-            d_i += 4 * x + 6;
-        else
-        {
-            d_i += 4 * (x - y) + 10;
-            --y;
-        }
-        coordinates_xy[2 * i] = ++x;
-        coordinates_xy[2 * i + 1] = y;
-    }
-    for(int i = 0; i < cnt; ++i)
-    {
-        coordinates_xy[2 * cnt + 2 * i]      =  coordinates_xy[2 * i + 1] + c_x;
-        coordinates_xy[2 * cnt + 2 * i + 1]  =  coordinates_xy[2 * i] + c_y;
-        coordinates_xy[4 * cnt + 2 * i]      =  coordinates_xy[2 * i + 1] + c_x;
-        coordinates_xy[4 * cnt + 2 * i + 1]  = -coordinates_xy[2 * i] + c_y;
-        coordinates_xy[6 * cnt + 2 * i]      =  coordinates_xy[2 * i] + c_x;
-        coordinates_xy[6 * cnt + 2 * i + 1]  = -coordinates_xy[2 * i + 1] + c_y;
-        coordinates_xy[8 * cnt + 2 * i]      = -coordinates_xy[2 * i] + c_x;
-        coordinates_xy[8 * cnt + 2 * i + 1]  = -coordinates_xy[2 * i + 1] + c_y;
-        coordinates_xy[10 * cnt + 2 * i]     = -coordinates_xy[2 * i + 1] + c_x;
-        coordinates_xy[10 * cnt + 2 * i + 1] = -coordinates_xy[2 * i] + c_y;
-        coordinates_xy[12 * cnt + 2 * i]     = -coordinates_xy[2 * i + 1] + c_x;
-        coordinates_xy[12 * cnt + 2 * i + 1] =  coordinates_xy[2 * i] + c_y;
-        coordinates_xy[14 * cnt + 2 * i]     = -coordinates_xy[2 * i] + c_x;
-        coordinates_xy[14 * cnt + 2 * i + 1] =  coordinates_xy[2 * i + 1] + c_y;
-        coordinates_xy[2 * i]               +=  c_x;
-        coordinates_xy[2 * i + 1]           +=  c_y;
-    }
-    return coordinates_xy;
-}
-
-float* normalize(std::vector<int> coordinates_xy, int cnt)
-{
-    float* coordinates = new float[3 * cnt];
-    for(int i = 0; i < cnt; ++i)
-    {
-        coordinates[3 * i] = (float)coordinates_xy[2 * i] / SCR_WIDTH;
-        coordinates[3 * i + 1] = (float)coordinates_xy[2 * i + 1] / SCR_HEIGHT;
-        coordinates[3 * i + 2] = 0.0f;
-    }
-    return coordinates;
-}
-
 int main()
 {
     glfwInit();
@@ -124,9 +70,10 @@ int main()
     std::vector<int> coordinates_xy = bresenhamCircle(100, -100, 400);
     
     int cnt = (int) coordinates_xy.size() / 2;
-    float* coordinates = normalize(coordinates_xy, cnt);
+    std::vector<float> coordinates;
+    normalize(coordinates_xy, coordinates, SCR_WIDTH, SCR_HEIGHT);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, 3 * cnt * sizeof(float), coordinates, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, 3 * cnt * sizeof(float), coordinates.data(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -197,7 +144,6 @@ int main()
     
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-    delete[] coordinates;
     
     glfwTerminate();
     return 0;
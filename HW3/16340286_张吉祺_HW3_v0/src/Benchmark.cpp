@@ -0,0 +1,606 @@
+//
+//  Benchmark.cpp
+//  CG
+//
+//  不打开窗口，测量 HW3 各光栅化函数的速度，并把输出的像素集合与记录的标准结果比对。
+//  用法：Benchmark [record]
+//  record 时打印当前实现的像素集合摘要，格式即下面的 golden 表，用于有意改变输出之后重新记录。
+//  rasterizeTriangle 对本机支持的每个行内核（scalar / sse2 / avx2）各跑一遍，分别报告不一致的个数
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Antialias.h"
+#include "Bresenham.h"
+#include "Circle.h"
+#include "Clip.h"
+#include "Polygon.h"
+#include "Rasterizer.h"
+#include "Scanline.h"
+
+typedef std::vector<std::pair<int, int>> PixelSet;
+
+// 像素集合的摘要：去重后的像素数和按 (x, y) 排序后的 FNV-1a 散列
+struct Digest {
+    size_t count;
+    uint64_t hash;
+};
+
+struct Golden {
+    const char* name;
+    size_t count;
+    uint64_t hash;
+};
+
+// 直线、圆、rasterization() 的结果由原始实现（baseline 中 Basic1 / Basic2 / Bonus1 的函数）记录，
+// triangle 为边函数光栅化（triangleSpans / rasterizeTriangle 的每个行内核 / TileRasterizer 都相同）的结果。
+// polygon 与逐像素按填充规则数交点的结果、clipped lines 与不裁剪的 Bresenham 再去掉保护带外的像素
+// 对比过后记录；wu 为覆盖率摘要，包含重复写出的像素和量化后的覆盖率
+const Golden golden[] = {
+    {"line L=4 deg=0", 4, 0x64dbcbc3ab5bf1a5ULL},
+    {"line L=4 deg=15", 4, 0xbc246d5a468152a5ULL},
+    {"line L=4 deg=30", 3, 0xf7604c1df9bea4e4ULL},
+    {"line L=4 deg=45", 3, 0x3b2fbef3e10d5c26ULL},
+    {"line L=4 deg=60", 3, 0xb2e55ec4648c3354ULL},
+    {"line L=4 deg=75", 4, 0xa4e4fe8d8cdfffc5ULL},
+    {"line L=4 deg=90", 4, 0x74e1afce84ba31a5ULL},
+    {"line L=4 deg=120", 3, 0xfde8358bbd27a6abULL},
+    {"line L=4 deg=165", 4, 0x957008a32b764f9aULL},
+    {"line L=4 deg=210", 3, 0xa851397e1ea8d692ULL},
+    {"line L=4 deg=300", 3, 0xda4f77695c34984aULL},
+    {"line L=16 deg=0", 16, 0x3f71fbaf4605ff25ULL},
+    {"line L=16 deg=15", 15, 0x1c70512aecae3d0aULL},
+    {"line L=16 deg=30", 14, 0xeaec941939148ec8ULL},
+    {"line L=16 deg=45", 11, 0x8b7e9f7faca83c6eULL},
+    {"line L=16 deg=60", 14, 0xc6e87a7feeb20e18ULL},
+    {"line L=16 deg=75", 15, 0x586a7696c32b8b3aULL},
+    {"line L=16 deg=90", 16, 0x8ced64576945df25ULL},
+    {"line L=16 deg=120", 14, 0xcb8e7bc52ae769c8ULL},
+    {"line L=16 deg=165", 15, 0x4ba3b547b80324acULL},
+    {"line L=16 deg=210", 14, 0x8634a42643bf3cdbULL},
+    {"line L=16 deg=300", 14, 0x0ff80616a135ed78ULL},
+    {"line L=64 deg=0", 64, 0x310e42af98fb7125ULL},
+    {"line L=64 deg=15", 62, 0xd26ef112f88c281dULL},
+    {"line L=64 deg=30", 55, 0x1a5629af58f3e316ULL},
+    {"line L=64 deg=45", 45, 0x8c0d4bd57f2a6b38ULL},
+    {"line L=64 deg=60", 55, 0x405302978b7d6466ULL},
+    {"line L=64 deg=75", 62, 0x4a6a18518f9bd71dULL},
+    {"line L=64 deg=90", 64, 0xd604b1591293d125ULL},
+    {"line L=64 deg=120", 55, 0xfff8c178b7eb49b5ULL},
+    {"line L=64 deg=165", 62, 0xcefb2a1f164bc964ULL},
+    {"line L=64 deg=210", 55, 0x83c462a31411a1daULL},
+    {"line L=64 deg=300", 55, 0x5edbacbf256fbaeaULL},
+    {"line L=256 deg=0", 256, 0x47b5eeb1c24f5b25ULL},
+    {"line L=256 deg=15", 247, 0xd4950341dc68d502ULL},
+    {"line L=256 deg=30", 222, 0xd299d9df700d02e4ULL},
+    {"line L=256 deg=45", 181, 0xb514d30765005b40ULL},
+    {"line L=256 deg=60", 222, 0x9fd48afa1f6902b4ULL},
+    {"line L=256 deg=75", 247, 0xb05a88b1ab1b6bf2ULL},
+    {"line L=256 deg=90", 256, 0x6790ddb0a160db25ULL},
+    {"line L=256 deg=120", 222, 0x6e71f0d2df4c754cULL},
+    {"line L=256 deg=165", 247, 0x30a1b44308754dc4ULL},
+    {"line L=256 deg=210", 222, 0x00c13f5b750fa7c7ULL},
+    {"line L=256 deg=300", 222, 0x370046d5e5ed94ecULL},
+    {"line L=1024 deg=0", 1024, 0x21b84c137ccdb625ULL},
+    {"line L=1024 deg=15", 989, 0xeb93ce5ce5ee40d5ULL},
+    {"line L=1024 deg=30", 887, 0x2d8bf8c66d3da0f1ULL},
+    {"line L=1024 deg=45", 724, 0x2bae9e715dc5fc3bULL},
+    {"line L=1024 deg=60", 887, 0x00640cb43de548f5ULL},
+    {"line L=1024 deg=75", 989, 0xa6ae4de31f8111adULL},
+    {"line L=1024 deg=90", 1024, 0x9ba98c76c9671625ULL},
+    {"line L=1024 deg=120", 887, 0x3678eeb6dae8c057ULL},
+    {"line L=1024 deg=165", 989, 0x1083547d7ca1b238ULL},
+    {"line L=1024 deg=210", 887, 0x8413cee2d5f833f7ULL},
+    {"line L=1024 deg=300", 887, 0x2b18c15d769fea97ULL},
+    {"lines N=1", 64, 0x5a05b28db4b23c24ULL},
+    {"lines N=16", 7426, 0x411cb0533af602ddULL},
+    {"lines N=256", 155016, 0xc1097cfa5c9e7e1dULL},
+    {"lines N=4096", 1272073, 0x0a09a573d4ea5b54ULL},
+    {"circle r=2", 4, 0x7fe088d3fe704b0dULL},
+    {"disc r=2", 21, 0x4b97329131eae985ULL},
+    {"circle r=8", 36, 0xf81b0fb37b01623dULL},
+    {"disc r=8", 221, 0x6e4303e13be54275ULL},
+    {"circle r=32", 172, 0x70dfb24dfc006bd5ULL},
+    {"disc r=32", 3305, 0x3268ab4ee800ca9dULL},
+    {"circle r=128", 716, 0x297dce6fb97212b5ULL},
+    {"disc r=128", 51857, 0x0b1f077d99cb7945ULL},
+    {"circle r=512", 2892, 0x1fc657dea088eb4dULL},
+    {"disc r=512", 824969, 0xab7c74a6fbc03235ULL},
+    {"rasterization right s=8", 42, 0x62ded6f4c9d6e0d5ULL},
+    {"triangle right s=8", 41, 0x994f341acf36aca0ULL},
+    {"rasterization sliver s=8", 32, 0xd492053c3cdb504aULL},
+    {"triangle sliver s=8", 30, 0x586f52e060bd9becULL},
+    {"rasterization obtuse s=8", 102, 0x439eab37fedb4236ULL},
+    {"triangle obtuse s=8", 95, 0x0dab2d99b2467213ULL},
+    {"rasterization right s=32", 441, 0x41ce4fee4e5787d5ULL},
+    {"triangle right s=32", 539, 0xdf0b6dfee98664e1ULL},
+    {"rasterization sliver s=32", 175, 0x9e25d85bab2a1f5aULL},
+    {"triangle sliver s=32", 447, 0xe43ef6f88ae0326dULL},
+    {"rasterization obtuse s=32", 1503, 0x4544e03119bbd9e6ULL},
+    {"triangle obtuse s=32", 1475, 0xdaad172defafffbdULL},
+    {"rasterization right s=128", 5730, 0x7df4172b9136d3b7ULL},
+    {"triangle right s=128", 8160, 0x996fc733a5239d50ULL},
+    {"rasterization sliver s=128", 1462, 0xce2477eeadeed195ULL},
+    {"triangle sliver s=128", 6882, 0xf974ae619836798cULL},
+    {"rasterization obtuse s=128", 23418, 0x567e6de3cc7e1f03ULL},
+    {"triangle obtuse s=128", 23266, 0x57b3adddb0b23353ULL},
+    {"rasterization right s=512", 87018, 0x597ae9e76a19a0feULL},
+    {"triangle right s=512", 128921, 0x5ecec1082bd8d4e4ULL},
+    {"rasterization sliver s=512", 17641, 0x7f86d8ba5ee70a8eULL},
+    {"triangle sliver s=512", 109722, 0xa7f0e6dec05f9547ULL},
+    {"rasterization obtuse s=512", 372486, 0xdcede2ef56c69158ULL},
+    {"triangle obtuse s=512", 371867, 0x52522341ef361408ULL},
+    {"tiles N=1", 981, 0xafb68cb640c1d177ULL},
+    {"tiles N=64", 31133, 0x4c4238c0601ac71bULL},
+    {"tiles N=1024", 443197, 0xec6a0bd59a9117e5ULL},
+    {"tiles N=16384", 1784712, 0x5dcaed029cc20952ULL},
+    {"polygon star eo s=8", 46, 0x634de36335d8a4deULL},
+    {"polygon star nz s=8", 66, 0x3fa13f710b8d13d4ULL},
+    {"polygon comb eo s=8", 184, 0xeef8b81f3e4f1445ULL},
+    {"polygon comb nz s=8", 184, 0xeef8b81f3e4f1445ULL},
+    {"polygon holed eo s=8", 216, 0xb70cfa70704da6c2ULL},
+    {"polygon holed nz s=8", 216, 0xb70cfa70704da6c2ULL},
+    {"polygon star eo s=32", 776, 0x4455b2e7ad2d05a9ULL},
+    {"polygon star nz s=32", 1122, 0xab893a129324002cULL},
+    {"polygon comb eo s=32", 2784, 0x8f26c74cd4bbaf5dULL},
+    {"polygon comb nz s=32", 2784, 0x8f26c74cd4bbaf5dULL},
+    {"polygon holed eo s=32", 3384, 0xe53f350e62092246ULL},
+    {"polygon holed nz s=32", 3384, 0xe53f350e62092246ULL},
+    {"polygon star eo s=128", 12692, 0x7d47cedb79d7c8e7ULL},
+    {"polygon star nz s=128", 18369, 0xafbeeafb3953b599ULL},
+    {"polygon comb eo s=128", 43904, 0xb969f396c81afdfdULL},
+    {"polygon comb nz s=128", 43904, 0xb969f396c81afdfdULL},
+    {"polygon holed eo s=128", 53816, 0x98e356a06431342eULL},
+    {"polygon holed nz s=128", 53816, 0x98e356a06431342eULL},
+    {"polygon star eo s=512", 203035, 0xeb8110864746b596ULL},
+    {"polygon star nz s=512", 293833, 0xd816028b8b21be6bULL},
+    {"polygon comb eo s=512", 699904, 0x177f98b69a4ccd6dULL},
+    {"polygon comb nz s=512", 699904, 0x177f98b69a4ccd6dULL},
+    {"polygon holed eo s=512", 859704, 0x6ef12b197def6ba6ULL},
+    {"polygon holed nz s=512", 859704, 0x6ef12b197def6ba6ULL},
+    {"clipped lines guard=0", 52033, 0x32f321689089028fULL},
+    {"clipped lines guard=64", 72901, 0xf93682df897b587cULL},
+    {"wu line L=16 deg=0", 34, 0xc5da4c511ff5c76bULL},
+    {"wu line L=16 deg=15", 32, 0x95ab7bdfe22a0c7bULL},
+    {"wu line L=16 deg=45", 24, 0x860c2d6c1b171df1ULL},
+    {"wu line L=16 deg=60", 30, 0x3833c4f74834c62fULL},
+    {"wu line L=16 deg=90", 34, 0xf3eb29cf6130b68bULL},
+    {"wu line L=16 deg=165", 32, 0x5c44d45ba310ece7ULL},
+    {"wu line L=16 deg=210", 30, 0xc7da459db81bf270ULL},
+    {"wu line L=16 deg=300", 30, 0xd50399b44f15647fULL},
+    {"wu line L=256 deg=0", 514, 0x7112338c8696cdbbULL},
+    {"wu line L=256 deg=15", 496, 0x1201dc482c6947d3ULL},
+    {"wu line L=256 deg=45", 364, 0x6a398d6ddaa789d7ULL},
+    {"wu line L=256 deg=60", 446, 0xef35163e42cc98dfULL},
+    {"wu line L=256 deg=90", 514, 0x6bb057d7a045c8ffULL},
+    {"wu line L=256 deg=165", 496, 0x47f6dd385bca380fULL},
+    {"wu line L=256 deg=210", 446, 0x965d831da1a7ca58ULL},
+    {"wu line L=256 deg=300", 446, 0x67d7722b2f6f789fULL},
+    {"wu circle r=1", 8, 0x62c49273de37db99ULL},
+    {"wu circle r=2", 20, 0xb87c5e89af5c0605ULL},
+    {"wu circle r=8", 88, 0x46a1a51a7e6a59d1ULL},
+    {"wu circle r=32", 360, 0x68d5b8f3bd914719ULL},
+    {"wu circle r=128", 1448, 0xd31ae3d9492de689ULL},
+    {"wu circle r=512", 5796, 0x11eaa5809dc667fdULL},
+};
+
+Digest digest(PixelSet pixels)
+{
+    std::sort(pixels.begin(), pixels.end());
+    pixels.erase(std::unique(pixels.begin(), pixels.end()), pixels.end());
+    uint64_t hash = 14695981039346656037ULL;
+    for(const auto& pixel : pixels)
+    {
+        const uint32_t words[2] = {(uint32_t) pixel.first, (uint32_t) pixel.second};
+        for(uint32_t word : words)
+            for(int shift = 0; shift < 32; shift += 8)
+            {
+                hash ^= (word >> shift) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+    }
+    return Digest{pixels.size(), hash};
+}
+
+PixelSet fromCoordinates(const std::vector<int>& coordinates_xy)
+{
+    PixelSet pixels(coordinates_xy.size() / 2);
+    for(size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = std::make_pair(coordinates_xy[2 * i], coordinates_xy[2 * i + 1]);
+    return pixels;
+}
+
+PixelSet fromSpans(const std::vector<Span>& spans)
+{
+    std::vector<int> coordinates_xy;
+    spansToPixels(spans, coordinates_xy);
+    return fromCoordinates(coordinates_xy);
+}
+
+// 读回帧缓冲中非零的像素，转为以屏幕中心为原点的坐标
+PixelSet fromFramebuffer(const Framebuffer& fb)
+{
+    PixelSet pixels;
+    for(int y = 0; y < fb.height; ++y)
+        for(int x = 0; x < fb.width; ++x)
+            if(fb.pixels[(size_t) y * fb.width + x])
+                pixels.push_back(std::make_pair(x - fb.origin_x, y - fb.origin_y));
+    return pixels;
+}
+
+// 反走样覆盖率的摘要：不去重，count 为输出的像素数，散列包含量化到 1/256 的覆盖率，
+// 所以重复写出的像素和覆盖率的变化都会改变摘要
+Digest digest(const Coverage& coverage)
+{
+    std::vector<std::pair<std::pair<int, int>, int>> pixels(coverage.size());
+    for(size_t i = 0; i < coverage.size(); ++i)
+        pixels[i] = std::make_pair(std::make_pair(coverage.x[i], coverage.y[i]), (int) std::lround(coverage.alpha[i] * 256.0f));
+    std::sort(pixels.begin(), pixels.end());
+    uint64_t hash = 14695981039346656037ULL;
+    for(const auto& pixel : pixels)
+    {
+        const uint32_t words[3] = {(uint32_t) pixel.first.first, (uint32_t) pixel.first.second, (uint32_t) pixel.second};
+        for(uint32_t word : words)
+            for(int shift = 0; shift < 32; shift += 8)
+            {
+                hash ^= (word >> shift) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+    }
+    return Digest{pixels.size(), hash};
+}
+
+// 重复调用 run 直到累计至少 min_seconds，返回每次调用的秒数
+template <typename Run>
+double measure(Run run, double min_seconds = 0.02)
+{
+    run();
+    size_t calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do
+    {
+        run();
+        ++calls;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while(elapsed < min_seconds);
+    return elapsed / calls;
+}
+
+bool recording = false;
+int failures = 0;
+
+// 本机可用的行内核，及各自在三角形用例中与 golden 不一致的个数
+struct KernelResult {
+    const char* name;
+    FillRowKernel kernel;
+    int cases;
+    int failures;
+};
+std::vector<KernelResult> kernels;
+
+void findKernels()
+{
+    kernels.push_back(KernelResult{"scalar", fillRowScalar, 0, 0});
+#ifdef RASTERIZER_X86_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse2"))
+        kernels.push_back(KernelResult{"sse2", fillRowSSE2, 0, 0});
+    else
+        printf("fill kernel sse2: not supported by this CPU, skipped\n");
+    if(__builtin_cpu_supports("avx2"))
+        kernels.push_back(KernelResult{"avx2", fillRowAVX2, 0, 0});
+    else
+        printf("fill kernel avx2: not supported by this CPU, skipped\n");
+#endif
+}
+
+// 打印一行结果，与 golden 表比对，一致时返回 true；
+// pixels 为一次调用输出的像素数（含重复），primitives 为一次调用的图元数
+bool report(const std::string& name, const char* implementation, const Digest& d, size_t pixels,
+            double seconds, size_t primitives)
+{
+    if(recording)
+    {
+        static std::vector<std::string> printed;
+        if(std::find(printed.begin(), printed.end(), name) == printed.end())
+        {
+            printed.push_back(name);
+            printf("    {\"%s\", %zu, 0x%016llxULL},\n", name.c_str(), d.count, (unsigned long long) d.hash);
+        }
+        return true;
+    }
+    const char* status = "missing";
+    for(const Golden& g : golden)
+        if(name == g.name)
+        {
+            status = g.count == d.count && g.hash == d.hash ? "ok" : "MISMATCH";
+            break;
+        }
+    if(strcmp(status, "ok") != 0)
+        ++failures;
+    printf("%-26s %-20s %12.1f ns/prim %10.1f Mpix/s  %s\n", name.c_str(), implementation,
+           seconds * 1e9 / primitives, pixels / seconds / 1e6, status);
+    return strcmp(status, "ok") == 0;
+}
+bool report(const std::string& name, const char* implementation, const PixelSet& output,
+            double seconds, size_t primitives)
+{
+    return report(name, implementation, digest(output), output.size(), seconds, primitives);
+}
+
+void benchmarkLines()
+{
+    const int lengths[] = {4, 16, 64, 256, 1024};
+    const int degrees[] = {0, 15, 30, 45, 60, 75, 90, 120, 165, 210, 300};
+    for(int length : lengths)
+        for(int degree : degrees)
+        {
+            double angle = degree * M_PI / 180.0;
+            int x_end = (int) std::lround(length * std::cos(angle));
+            int y_end = (int) std::lround(length * std::sin(angle));
+            std::string name = "line L=" + std::to_string(length) + " deg=" + std::to_string(degree);
+
+            std::vector<int> coordinates_xy;
+            double seconds = measure([&] { coordinates_xy = bresenhamLine(0, 0, x_end, y_end); });
+            report(name, "bresenhamLine", fromCoordinates(coordinates_xy), seconds, 1);
+
+            std::vector<Span> spans;
+            Segment segment{0, 0, x_end, y_end};
+            seconds = measure([&] { spans.clear(); bresenhamLineSpans(segment, spans); });
+            report(name, "bresenhamLineSpans", fromSpans(spans), seconds, 1);
+        }
+}
+
+// 批量画线：固定种子的线性同余序列生成线段，比较不同批大小下每条线段的开销
+void benchmarkLineBatches()
+{
+    const int counts[] = {1, 16, 256, 4096};
+    for(int count : counts)
+    {
+        std::vector<Segment> segments(count);
+        uint32_t seed = 12345;
+        auto next = [&seed](int range) { seed = seed * 1664525u + 1013904223u; return (int) (seed >> 8) % (2 * range + 1) - range; };
+        for(Segment& s : segments)
+            s = Segment{next(800), next(600), next(800), next(600)};
+        std::string name = "lines N=" + std::to_string(count);
+        std::vector<int> coordinates_xy;
+        double seconds = measure([&] { coordinates_xy.clear(); bresenhamLines(segments, coordinates_xy); });
+        report(name, "bresenhamLines", fromCoordinates(coordinates_xy), seconds, count);
+    }
+}
+
+void benchmarkCircles()
+{
+    const int radii[] = {2, 8, 32, 128, 512};
+    for(int r : radii)
+    {
+        std::string name = "circle r=" + std::to_string(r);
+        std::vector<int> coordinates_xy;
+        double seconds = measure([&] { coordinates_xy = bresenhamCircle(0, 0, r); });
+        report(name, "bresenhamCircle", fromCoordinates(coordinates_xy), seconds, 1);
+
+        std::vector<Span> spans;
+        seconds = measure([&] { spans.clear(); bresenhamCircleSpans(0, 0, r, spans); });
+        report(name, "bresenhamCircleSpans", fromSpans(spans), seconds, 1);
+
+        name = "disc r=" + std::to_string(r);
+        seconds = measure([&] { spans.clear(); circleSpans(r, true, spans); });
+        report(name, "circleSpans", fromSpans(spans), seconds, 1);
+    }
+}
+
+void benchmarkTriangles()
+{
+    // 每个尺寸三种形状：直角、细长、钝角
+    const int sizes[] = {8, 32, 128, 512};
+    const int shapes[3][6] = {
+        {0, 0, 1, 0, 0, 1},
+        {-1, -1, 1, 0, 0, 0},
+        {-1, 0, 1, -1, 0, 1}
+    };
+    const char* shape_names[3] = {"right", "sliver", "obtuse"};
+    for(int size : sizes)
+        for(int k = 0; k < 3; ++k)
+        {
+            const int* v = shapes[k];
+            int jitter = size / 7;
+            Triangle t{v[0] * size, v[1] * size, v[2] * size + jitter, v[3] * size, v[4] * size, v[5] * size - jitter, 1};
+            std::string suffix = std::string(" ") + shape_names[k] + " s=" + std::to_string(size);
+
+            // Bonus1 原来的逐像素路径：边像素进优先队列，再逐行填充
+            std::vector<std::pair<int, int>> filled;
+            double seconds = measure([&]
+            {
+                std::priority_queue<std::pair<int, int>> coordinates_xy;
+                bresenhamLine(coordinates_xy, t.x1, t.y1, t.x2, t.y2);
+                bresenhamLine(coordinates_xy, t.x2, t.y2, t.x3, t.y3);
+                bresenhamLine(coordinates_xy, t.x3, t.y3, t.x1, t.y1);
+                filled = rasterization(coordinates_xy);
+            });
+            report("rasterization" + suffix, "rasterization", filled, seconds, 1);
+
+            std::string name = "triangle" + suffix;
+            std::vector<Span> spans;
+            seconds = measure([&] { spans.clear(); triangleSpans(t, spans); });
+            report(name, "triangleSpans", fromSpans(spans), seconds, 1);
+
+            int extent = 3 * size + 8;
+            std::vector<uint32_t> pixels((size_t) extent * extent);
+            Framebuffer fb{pixels.data(), extent, extent, extent / 2, extent / 2};
+            EdgeSetup e;
+            setupTriangle(t, e);
+            for(KernelResult& k : kernels)
+            {
+                std::fill(pixels.begin(), pixels.end(), 0);
+                seconds = measure([&] { rasterizeTriangle(e, t.color, fb, 0, 0, extent - 1, extent - 1, k.kernel); });
+                std::string implementation = std::string("rasterize/") + k.name;
+                ++k.cases;
+                if(!report(name, implementation.c_str(), fromFramebuffer(fb), seconds, 1))
+                    ++k.failures;
+            }
+        }
+}
+
+// 多边形扫描转换：凹多边形、自相交的五角星（两种填充规则结果不同）、带洞的正方形
+void benchmarkPolygons()
+{
+    const int sizes[] = {8, 32, 128, 512};
+    PolygonScanner scanner;
+    for(int size : sizes)
+    {
+        std::vector<std::pair<const char*, std::vector<PolygonScanner::Contour>>> shapes;
+        PolygonScanner::Contour star;
+        for(int i = 0; i < 5; ++i)
+        {
+            double angle = M_PI / 2 + i * 4 * M_PI / 5;
+            star.push_back(std::make_pair((int) std::lround(size * std::cos(angle)), (int) std::lround(size * std::sin(angle))));
+        }
+        shapes.push_back(std::make_pair("star", std::vector<PolygonScanner::Contour>{star}));
+        PolygonScanner::Contour comb = {{-size, -size}, {size, -size}, {size, size}, {size / 2, -size / 3},
+                                        {0, size}, {-size / 2, -size / 3}, {-size, size}};
+        shapes.push_back(std::make_pair("comb", std::vector<PolygonScanner::Contour>{comb}));
+        // 洞的方向与外轮廓相反，两种规则下都是洞
+        PolygonScanner::Contour outer = {{-size, -size}, {size, -size}, {size, size}, {-size, size}};
+        PolygonScanner::Contour hole = {{-size / 2, -size / 3}, {-size / 3, size / 2}, {size / 2, size / 3}, {size / 3, -size / 2}};
+        shapes.push_back(std::make_pair("holed", std::vector<PolygonScanner::Contour>{outer, hole}));
+        for(const auto& shape : shapes)
+            for(int rule = 0; rule < 2; ++rule)
+            {
+                std::string name = std::string("polygon ") + shape.first + (rule ? " nz" : " eo") + " s=" + std::to_string(size);
+                std::vector<Span> spans;
+                double seconds = measure([&] { spans.clear(); scanner.scan(shape.second, (FillRule) rule, spans); });
+                report(name, "PolygonScanner", fromSpans(spans), seconds, 1);
+            }
+    }
+}
+
+// 裁剪后的直线：跨出视口和保护带的随机线段，只保留保护带内的像素
+void benchmarkClippedLines()
+{
+    const int guards[] = {0, 64};
+    std::vector<Segment> segments(256);
+    uint32_t seed = 4242;
+    auto next = [&seed](int range) { seed = seed * 1664525u + 1013904223u; return (int) (seed >> 8) % (2 * range + 1) - range; };
+    for(Segment& s : segments)
+        s = Segment{next(1200), next(900), next(1200), next(900)};
+    for(int guard : guards)
+    {
+        Clipper clipper(ClipRect{-400, -300, 400, 300}, guard);
+        std::string name = "clipped lines guard=" + std::to_string(guard);
+        std::vector<int> coordinates_xy;
+        double seconds = measure([&] { coordinates_xy.clear(); clipper.lines(segments.data(), segments.size(), coordinates_xy); });
+        report(name, "Clipper::lines", fromCoordinates(coordinates_xy), seconds, segments.size());
+    }
+}
+
+// 反走样直线和圆，比对像素、重复次数和覆盖率
+void benchmarkWu()
+{
+    const int lengths[] = {16, 256};
+    const int degrees[] = {0, 15, 45, 60, 90, 165, 210, 300};
+    for(int length : lengths)
+        for(int degree : degrees)
+        {
+            double angle = degree * M_PI / 180.0;
+            Segment segment{0, 0, (int) std::lround(length * std::cos(angle)), (int) std::lround(length * std::sin(angle))};
+            std::string name = "wu line L=" + std::to_string(length) + " deg=" + std::to_string(degree);
+            Coverage coverage;
+            double seconds = measure([&] { coverage.clear(); wuLines(&segment, 1, coverage); });
+            report(name, "wuLines", digest(coverage), coverage.size(), seconds, 1);
+        }
+    const int radii[] = {1, 2, 8, 32, 128, 512};
+    for(int r : radii)
+    {
+        std::string name = "wu circle r=" + std::to_string(r);
+        Coverage coverage;
+        double seconds = measure([&] { coverage.clear(); wuCircle(0, 0, (float) r, coverage); });
+        report(name, "wuCircle", digest(coverage), coverage.size(), seconds, 1);
+    }
+}
+
+// 反走样圆的覆盖率像素必须两两不同：同一像素出现两次会被 blendCoverage 混合两次，
+// 坐标轴和对角线附近比应有的覆盖率更深
+void checkWuCircles()
+{
+    const float radii[] = {0.3f, 0.5f, 1.0f, 1.5f, 2.0f, 2.5f, 7.3f, 8.0f, 31.9f, 100.0f, 511.5f};
+    for(float r : radii)
+    {
+        Coverage coverage;
+        wuCircle(3, -2, r, coverage);
+        PixelSet pixels(coverage.size());
+        for(size_t i = 0; i < coverage.size(); ++i)
+            pixels[i] = std::make_pair(coverage.x[i], coverage.y[i]);
+        std::sort(pixels.begin(), pixels.end());
+        size_t duplicates = pixels.size() - (std::unique(pixels.begin(), pixels.end()) - pixels.begin());
+        if(duplicates)
+            ++failures;
+        char name[32];
+        snprintf(name, sizeof(name), "wu circle r=%g", r);
+        if(!recording)
+            printf("%-26s %-20s %12zu pixels %10zu duplicate  %s\n", name, "wuCircle", coverage.size(),
+                   duplicates, duplicates ? "MISMATCH" : "ok");
+    }
+}
+
+// 分块多线程光栅化：不同三角形数量下每个三角形的开销，结果为整幅帧缓冲的像素集合
+void benchmarkTileRasterizer()
+{
+    const int counts[] = {1, 64, 1024, 16384};
+    TileRasterizer rasterizer;
+    std::vector<uint32_t> pixels(1600 * 1200);
+    Framebuffer fb{pixels.data(), 1600, 1200, 800, 600};
+    for(int count : counts)
+    {
+        std::vector<Triangle> triangles(count);
+        uint32_t seed = 777;
+        auto next = [&seed](int range) { seed = seed * 1664525u + 1013904223u; return (int) (seed >> 8) % (2 * range + 1) - range; };
+        for(Triangle& t : triangles)
+        {
+            int c_x = next(760), c_y = next(560);
+            t = Triangle{c_x + next(40), c_y + next(40), c_x + next(40), c_y + next(40), c_x + next(40), c_y + next(40), 1};
+        }
+        std::fill(pixels.begin(), pixels.end(), 0);
+        double seconds = measure([&] { rasterizer.drawTriangles(triangles, fb); });
+        std::string name = "tiles N=" + std::to_string(count);
+        report(name, "TileRasterizer", fromFramebuffer(fb), seconds, count);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    recording = argc > 1 && strcmp(argv[1], "record") == 0;
+    if(!recording)
+    {
+        const char* kernel;
+        selectFillRow(&kernel);
+        printf("fill kernel: %s, threads: %u\n", kernel, TileRasterizer().threadCount());
+    }
+    findKernels();
+    benchmarkLines();
+    benchmarkLineBatches();
+    benchmarkCircles();
+    benchmarkTriangles();
+    benchmarkTileRasterizer();
+    benchmarkPolygons();
+    benchmarkClippedLines();
+    benchmarkWu();
+    checkWuCircles();
+    if(!recording)
+    {
+        for(const KernelResult& k : kernels)
+            if(k.failures)
+                printf("fill kernel %s: %d of %d triangle case(s) do not match\n", k.name, k.failures, k.cases);
+            else
+                printf("fill kernel %s: all %d triangle cases match\n", k.name, k.cases);
+        printf(failures ? "%d case(s) do not match the golden pixel sets\n" : "all cases match the golden pixel sets\n", failures);
+    }
+    return failures ? 1 : 0;
+}
@@ -1,8 +1,9 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
-#include <queue>
 #include <vector>
+#include "Bresenham.h"
+#include "Rasterizer.h"
 
 const uint SCR_WIDTH = 800;
 const uint SCR_HEIGHT = 600;
@@ -26,102 +27,19 @@ void frame_resize(GLFWwindow* window, int width, int height)
     glViewport(0, 0, width, height);
 }
 
+// 按 P 在跨度模式和逐像素调试模式之间切换
+bool debug_pixels = false;
+
 void processInput(GLFWwindow *window)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
     glfwSetWindowShouldClose(window, true);
 }
 
-void swap(int& a, int& b)
-{
-    int c(std::move(a));
-    a = std::move(b);
-    b = std::move(c);
-}
-
-void bresenhamLine(std::priority_queue<std::pair<int, int>>& coordinates_xy,
-                   int x_start, int y_start, int x_end, int y_end)
-{
-    int sign = 1;
-    int delta_x = x_end - x_start;
-    if(delta_x < 0)
-    {
-        delta_x *= -1;
-        swap(x_start, x_end);
-        swap(y_start, y_end);
-    }
-    int delta_y = y_end - y_start;
-    // 斜率为负，作y轴轴对称
-    if(delta_y < 0)
-    {
-        delta_y *= -1;
-        sign = -1;
-        swap(x_start, x_end);
-        swap(y_start, y_end);
-        x_start *= -1;
-        x_end *= -1;
-    }
-    bool rotate = false;
-    // 斜率大于1，x y交换
-    if(delta_y > delta_x)
-    {
-        swap(x_start, y_start);
-        swap(x_end, y_end);
-        swap(delta_x, delta_y);
-        rotate = true;
-    }
-    int p_i = 2 * delta_y - delta_x;
-    int y_last = y_start;
-    for(int i = 0; i < delta_x; ++i)
-    {
-        if(p_i <= 0)
-        p_i += 2 * delta_y;
-        else
-        {
-            ++y_last;
-            p_i += 2 * delta_y - 2 * delta_x;
-        }
-        coordinates_xy.push(std::pair<int, int>(
-            rotate ? x_start + i : y_last,
-            rotate ? sign * y_last : sign * (x_start + i)));
-    }
-}
-
-std::vector<std::pair<int, int>> rasterization(std::priority_queue<std::pair<int, int>> coordinates_xy)
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
-    std::vector<std::pair<int, int>> rasterized_coordinates_xy;
-    while(!coordinates_xy.empty())
-    {
-        std::pair<int, int> end = coordinates_xy.top();
-        std::pair<int, int> start = end;
-        coordinates_xy.pop();
-        if(!coordinates_xy.empty())
-        {
-            start = coordinates_xy.top();
-            if(start.first != end.first)
-                start = end;
-            else
-                coordinates_xy.pop();
-        }
-        rasterized_coordinates_xy.push_back(std::pair<int, int>(start.second, start.first));
-        rasterized_coordinates_xy.push_back(std::pair<int, int>(end.second, start.first));
-        for(int x = start.second; x <= end.second; ++x)
-            rasterized_coordinates_xy.push_back(std::pair<int, int>(x, start.first));
-    }
-    return rasterized_coordinates_xy;
-}
-
-float* normalize(std::vector<std::pair<int, int>> rasterized_coordinates_xy)
-{
-    int cnt = (int) rasterized_coordinates_xy.size();
-    float* coordinates = new float[3 * cnt];
-    for(int i = 0; i < cnt; ++i)
-    {
-        coordinates[3 * i] = (float) rasterized_coordinates_xy[i].first / SCR_WIDTH;
-        coordinates[3 * i + 1] = (float) rasterized_coordinates_xy[i].second / SCR_HEIGHT;
-        coordinates[3 * i + 2] = 0.0f;
-    }
-    return coordinates;
+    if (key == GLFW_KEY_P && action == GLFW_PRESS)
+        debug_pixels = !debug_pixels;
 }
 
 int main()
@@ -144,6 +62,7 @@ int main()
     }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, frame_resize);
+    glfwSetKeyCallback(window, key_callback);
     
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -152,11 +71,10 @@ int main()
     }
     
     
-    uint VAO, VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    
-    glBindVertexArray(VAO);
+    // 0: 跨度，每个跨度一条 GL_LINES 线段；1: 逐像素 GL_POINTS
+    uint VAO[2], VBO[2];
+    glGenVertexArrays(2, VAO);
+    glGenBuffers(2, VBO);
     
     int v1_x = -300;
     int v1_y = 500;
@@ -165,16 +83,28 @@ int main()
     int v3_x = 300;
     int v3_y = -500;
     
-    std::priority_queue<std::pair<int, int>> coordinates_xy;
-    bresenhamLine(coordinates_xy, v1_x, v1_y, v2_x, v2_y);
-    bresenhamLine(coordinates_xy, v2_x, v2_y, v3_x, v3_y);
-    bresenhamLine(coordinates_xy, v3_x, v3_y, v1_x, v1_y);
+    std::vector<Span> spans;
+    triangleSpans(Triangle{v1_x, v1_y, v2_x, v2_y, v3_x, v3_y, 0}, spans);
+    std::vector<int> span_coordinates_xy;
+    spansToLines(spans, span_coordinates_xy);
+    int cnt_span = (int) span_coordinates_xy.size() / 2;
+    std::vector<float> span_coordinates;
+    normalize(span_coordinates_xy, span_coordinates, SCR_WIDTH, SCR_HEIGHT);
+    glBindVertexArray(VAO[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, 3 * cnt_span * sizeof(float), span_coordinates.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
     
-    std::vector<std::pair<int, int>> rasterized_coordinates_xy = rasterization(coordinates_xy);
-    int cnt = (int) rasterized_coordinates_xy.size();
-    float* coordinates = normalize(rasterized_coordinates_xy);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, 3 * cnt * sizeof(float), coordinates, GL_STATIC_DRAW);
+    // 调试模式逐个画出同一组跨度中的像素，与跨度模式覆盖的像素完全相同
+    std::vector<int> pixel_coordinates_xy;
+    spansToPixels(spans, pixel_coordinates_xy);
+    int cnt = (int) pixel_coordinates_xy.size() / 2;
+    std::vector<float> pixel_coordinates;
+    normalize(pixel_coordinates_xy, pixel_coordinates, SCR_WIDTH, SCR_HEIGHT);
+    glBindVertexArray(VAO[1]);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO[1]);
+    glBufferData(GL_ARRAY_BUFFER, 3 * cnt * sizeof(float), pixel_coordinates.data(), GL_STATIC_DRAW);
     
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -231,10 +161,17 @@ int main()
         glClear(GL_COLOR_BUFFER_BIT);
         
         glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
-        
-        glPointSize(5);
-        glDrawArrays(GL_POINTS, 0, cnt);
+        if (debug_pixels)
+        {
+            glBindVertexArray(VAO[1]);
+            glPointSize(5);
+            glDrawArrays(GL_POINTS, 0, cnt);
+        }
+        else
+        {
+            glBindVertexArray(VAO[0]);
+            glDrawArrays(GL_LINES, 0, cnt_span);
+        }
         
         // swap buffers
         glfwSwapBuffers(window);
@@ -243,9 +180,8 @@ int main()
         glfwPollEvents();
     }
     
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    delete[] coordinates;
+    glDeleteVertexArrays(2, VAO);
+    glDeleteBuffers(2, VBO);
     
     glfwTerminate();
     return 0;
@@ -0,0 +1,279 @@
+//
+//  Bresenham.h
+//  CG
+//
+
+#ifndef Bresenham_h
+#define Bresenham_h
+
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "Span.h"
+
+struct Segment {
+    int x_start, y_start;
+    int x_end, y_end;
+};
+
+// 一条线段输出的像素数，与 bresenhamLine 写出的点数一致
+inline int bresenhamLineCount(int x_start, int y_start, int x_end, int y_end)
+{
+    int delta_x = std::abs(x_end - x_start);
+    int delta_y = std::abs(y_end - y_start);
+    return delta_x > delta_y ? delta_x : delta_y;
+}
+
+// 把线段变换到 0 <= 斜率 <= 1、x 递增的标准位置，记录变换方式以便还原
+struct BresenhamSetup {
+    int sign;
+    bool rotate;
+    int x_start;
+    int y_start;
+    int delta_x;
+    int delta_y;
+
+    BresenhamSetup(int x_start, int y_start, int x_end, int y_end)
+    {
+        sign = 1;
+        int delta_x = x_end - x_start;
+        if(delta_x < 0)
+        {
+            delta_x *= -1;
+            std::swap(x_start, x_end);
+            std::swap(y_start, y_end);
+        }
+        int delta_y = y_end - y_start;
+        // 斜率为负，作y轴轴对称
+        if(delta_y < 0)
+        {
+            delta_y *= -1;
+            sign = -1;
+            std::swap(x_start, x_end);
+            std::swap(y_start, y_end);
+            x_start *= -1;
+            x_end *= -1;
+        }
+        rotate = false;
+        // 斜率大于1，x y交换
+        if(delta_y > delta_x)
+        {
+            std::swap(x_start, y_start);
+            std::swap(x_end, y_end);
+            std::swap(delta_x, delta_y);
+            rotate = true;
+        }
+        this->x_start = x_start;
+        this->y_start = y_start;
+        this->delta_x = delta_x;
+        this->delta_y = delta_y;
+    }
+    // 第 i 步之后 y 增加的次数，即 max(0, ceil((2dy(i + 1) - dx) / 2dx))
+    int risesAt(int i) const
+    {
+        long long numerator = 2LL * delta_y * (i + 1) - delta_x;
+        if(numerator <= 0)
+            return 0;
+        return (int) ((numerator + 2LL * delta_x - 1) / (2LL * delta_x));
+    }
+    // 第 i 个像素在原坐标系下的位置，O(1)
+    void pixel(int i, int& x, int& y) const
+    {
+        int y_last = y_start + risesAt(i);
+        x = rotate ? sign * y_last : sign * (x_start + i);
+        y = rotate ? x_start + i : y_last;
+    }
+};
+
+// 按原 bresenhamLine 的顺序访问第 first 到 last 个像素 plot(x, y)，
+// 起点的判别式由 risesAt 直接算出，不需要从头迭代
+template <typename Plot>
+inline void bresenhamPlot(const BresenhamSetup& b, int first, int last, Plot plot)
+{
+    if(first < 0)
+        first = 0;
+    if(last >= b.delta_x)
+        last = b.delta_x - 1;
+    if(first > last)
+        return;
+    int rises = first > 0 ? b.risesAt(first - 1) : 0;
+    // 乘积在线段很长、从中途开始时会超出 int，相减之后回到 [-2dx, 2dy]
+    int p_i = (int) (2LL * b.delta_y * (first + 1) - b.delta_x - 2LL * b.delta_x * rises);
+    int y_last = b.y_start + rises;
+    for(int i = first; i <= last; ++i)
+    {
+        if(p_i <= 0)
+        p_i += 2 * b.delta_y;
+        else
+        {
+            ++y_last;
+            p_i += 2 * b.delta_y - 2 * b.delta_x;
+        }
+        plot(b.rotate ? b.sign * y_last : b.sign * (b.x_start + i), b.rotate ? b.x_start + i : y_last);
+    }
+}
+
+// 按原 bresenhamLine 的顺序逐个访问线段上的像素 plot(x, y)，返回像素数
+template <typename Plot>
+inline int bresenhamPlot(int x_start, int y_start, int x_end, int y_end, Plot plot)
+{
+    BresenhamSetup b(x_start, y_start, x_end, y_end);
+    bresenhamPlot(b, 0, b.delta_x - 1, plot);
+    return b.delta_x;
+}
+
+// 把一条线段的像素 (x, y) 交替写入 coordinates_xy，返回写入的点数
+inline int bresenhamLine(int* coordinates_xy, int x_start, int y_start, int x_end, int y_end)
+{
+    return bresenhamPlot(x_start, y_start, x_end, y_end, [&coordinates_xy](int x, int y)
+    {
+        *coordinates_xy++ = x;
+        *coordinates_xy++ = y;
+    });
+}
+
+// 跨度输出：同一行上连续的像素合并为一段，平缓的线段每行只产生一个跨度
+inline void bresenhamLineSpans(const Segment& segment, std::vector<Span>& spans)
+{
+    bresenhamPlot(segment.x_start, segment.y_start, segment.x_end, segment.y_end, [&spans](int x, int y)
+    {
+        appendPixel(spans, x, y);
+    });
+}
+
+inline void bresenhamLineSpans(const Segment* segments, size_t count, std::vector<Span>& spans)
+{
+    for(size_t i = 0; i < count; ++i)
+        bresenhamLineSpans(segments[i], spans);
+}
+
+// 批量画线，结果追加在 coordinates_xy 末尾。
+// 先统计总点数一次性扩容，调用方复用同一个 vector（clear 不释放容量）时稳定后不再分配内存
+inline void bresenhamLines(const Segment* segments, size_t count, std::vector<int>& coordinates_xy)
+{
+    size_t total = 0;
+    for(size_t i = 0; i < count; ++i)
+        total += bresenhamLineCount(segments[i].x_start, segments[i].y_start, segments[i].x_end, segments[i].y_end);
+    size_t offset = coordinates_xy.size();
+    coordinates_xy.resize(offset + 2 * total);
+    int* out = coordinates_xy.data() + offset;
+    for(size_t i = 0; i < count; ++i)
+        out += 2 * bresenhamLine(out, segments[i].x_start, segments[i].y_start, segments[i].x_end, segments[i].y_end);
+}
+
+inline void bresenhamLines(const std::vector<Segment>& segments, std::vector<int>& coordinates_xy)
+{
+    bresenhamLines(segments.data(), segments.size(), coordinates_xy);
+}
+
+inline std::vector<int> bresenhamLine(int x_start, int y_start, int x_end, int y_end)
+{
+    std::vector<int> coordinates_xy(2 * bresenhamLineCount(x_start, y_start, x_end, y_end));
+    bresenhamLine(coordinates_xy.data(), x_start, y_start, x_end, y_end);
+    return coordinates_xy;
+}
+
+inline std::vector<int> bresenhamCircle(int c_x, int c_y, int r)
+{
+    int cnt = r / sqrt(2);
+    std::vector<int> coordinates_xy(16 * cnt);
+    int x = 0;
+    int y = r;
+    int d_i = 3 - 2 * r;
+    coordinates_xy[0] = x;
+    coordinates_xy[1] = y;
+    for(int i = 1; i < cnt; ++i)
+    {
+        if(d_i <= 0)
+        d_i += 4 * x + 6;
+        else
+        {
+            d_i += 4 * (x - y) + 10;
+            --y;
+        }
+        coordinates_xy[2 * i] = ++x;
+        coordinates_xy[2 * i + 1] = y;
+    }
+    for(int i = 0; i < cnt; ++i)
+    {
+        coordinates_xy[2 * cnt + 2 * i]      =  coordinates_xy[2 * i + 1] + c_x;
+        coordinates_xy[2 * cnt + 2 * i + 1]  =  coordinates_xy[2 * i] + c_y;
+        coordinates_xy[4 * cnt + 2 * i]      =  coordinates_xy[2 * i + 1] + c_x;
+        coordinates_xy[4 * cnt + 2 * i + 1]  = -coordinates_xy[2 * i] + c_y;
+        coordinates_xy[6 * cnt + 2 * i]      =  coordinates_xy[2 * i] + c_x;
+        coordinates_xy[6 * cnt + 2 * i + 1]  = -coordinates_xy[2 * i + 1] + c_y;
+        coordinates_xy[8 * cnt + 2 * i]      = -coordinates_xy[2 * i] + c_x;
+        coordinates_xy[8 * cnt + 2 * i + 1]  = -coordinates_xy[2 * i + 1] + c_y;
+        coordinates_xy[10 * cnt + 2 * i]     = -coordinates_xy[2 * i + 1] + c_x;
+        coordinates_xy[10 * cnt + 2 * i + 1] = -coordinates_xy[2 * i] + c_y;
+        coordinates_xy[12 * cnt + 2 * i]     = -coordinates_xy[2 * i + 1] + c_x;
+        coordinates_xy[12 * cnt + 2 * i + 1] =  coordinates_xy[2 * i] + c_y;
+        coordinates_xy[14 * cnt + 2 * i]     = -coordinates_xy[2 * i] + c_x;
+        coordinates_xy[14 * cnt + 2 * i + 1] =  coordinates_xy[2 * i + 1] + c_y;
+        coordinates_xy[2 * i]               +=  c_x;
+        coordinates_xy[2 * i + 1]           +=  c_y;
+    }
+    return coordinates_xy;
+}
+
+// 跨度输出的圆，像素集合与 bresenhamCircle 相同。
+// 第一个八分圆里 y 相同的一段连续 x 对应上下两行各两个跨度，
+// 相邻的两个八分圆每行只有单个像素
+inline void bresenhamCircleSpans(int c_x, int c_y, int r, std::vector<Span>& spans)
+{
+    int cnt = r / sqrt(2);
+    int x = 0;
+    int y = r;
+    int d_i = 3 - 2 * r;
+    int run_start = 0;
+    for(int i = 0; i < cnt; ++i)
+    {
+        int y_next = y;
+        if(i + 1 < cnt)
+        {
+            if(d_i <= 0)
+            d_i += 4 * x + 6;
+            else
+            {
+                d_i += 4 * (x - y) + 10;
+                --y_next;
+            }
+        }
+        // 当前行结束：输出 [run_start, x] 这一段
+        if(i + 1 == cnt || y_next != y)
+        {
+            spans.push_back(Span{c_y + y, c_x + run_start, c_x + x});
+            spans.push_back(Span{c_y + y, c_x - x, c_x - run_start});
+            spans.push_back(Span{c_y - y, c_x + run_start, c_x + x});
+            spans.push_back(Span{c_y - y, c_x - x, c_x - run_start});
+            for(int k = run_start; k <= x; ++k)
+            {
+                spans.push_back(Span{c_y + k, c_x + y, c_x + y});
+                spans.push_back(Span{c_y + k, c_x - y, c_x - y});
+                spans.push_back(Span{c_y - k, c_x + y, c_x + y});
+                spans.push_back(Span{c_y - k, c_x - y, c_x - y});
+            }
+            run_start = x + 1;
+        }
+        y = y_next;
+        ++x;
+    }
+}
+
+// 像素坐标转为 NDC 顶点 (x, y, 0)，写入复用的 coordinates
+inline void normalize(const std::vector<int>& coordinates_xy, std::vector<float>& coordinates,
+                      unsigned width, unsigned height)
+{
+    size_t cnt = coordinates_xy.size() / 2;
+    coordinates.resize(3 * cnt);
+    for(size_t i = 0; i < cnt; ++i)
+    {
+        coordinates[3 * i] = (float) coordinates_xy[2 * i] / width;
+        coordinates[3 * i + 1] = (float) coordinates_xy[2 * i + 1] / height;
+        coordinates[3 * i + 2] = 0.0f;
+    }
+}
+
+#endif /* Bresenham_h */
@@ -0,0 +1,248 @@
+//
+//  Circle.h
+//  CG
+//
+
+#ifndef Circle_h
+#define Circle_h
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <vector>
+#include "Bresenham.h"
+#include "Span.h"
+
+// 以原点为圆心的圆。轮廓与 bresenhamCircle 的像素集合相同，
+// 填充时每行取轮廓在该行的最左到最右
+inline void circleSpans(int r, bool filled, std::vector<Span>& spans)
+{
+    if(!filled)
+    {
+        bresenhamCircleSpans(0, 0, r, spans);
+        return;
+    }
+    // half[y] 为第 y 行（y >= 0）的半宽，只算一个八分圆，其余由对称得到。
+    // bresenhamCircle 只走 r / sqrt(2) 步，45 度附近会漏行，填充时走到 x > y 为止
+    std::vector<int> half(r + 1, -1);
+    int x = 0;
+    int y = r;
+    int d_i = 3 - 2 * r;
+    while(x <= y)
+    {
+        half[y] = std::max(half[y], x);
+        half[x] = std::max(half[x], y);
+        if(d_i <= 0)
+        d_i += 4 * x + 6;
+        else
+        {
+            d_i += 4 * (x - y) + 10;
+            --y;
+        }
+        ++x;
+    }
+    for(int row = -r; row <= r; ++row)
+    {
+        int w = half[row < 0 ? -row : row];
+        if(w >= 0)
+            spans.push_back(Span{row, -w, w});
+    }
+}
+
+// 中点椭圆算法，分斜率绝对值小于 1 和大于 1 两个区域，四分之一对称
+inline void ellipseSpans(int rx, int ry, bool filled, std::vector<Span>& spans)
+{
+    if(rx <= 0 || ry <= 0)
+        return;
+    // half_min / half_max：第一象限每行像素 x 的范围
+    std::vector<int> half_min(ry + 1, rx + 1);
+    std::vector<int> half_max(ry + 1, -1);
+    long long rx2 = (long long) rx * rx;
+    long long ry2 = (long long) ry * ry;
+    int x = 0;
+    int y = ry;
+    // 区域 1：x 为主方向
+    long long d = 4 * ry2 - 4 * rx2 * ry + rx2;
+    while(ry2 * x < rx2 * y)
+    {
+        half_min[y] = std::min(half_min[y], x);
+        half_max[y] = std::max(half_max[y], x);
+        if(d < 0)
+            d += 4 * ry2 * (2 * x + 3);
+        else
+        {
+            d += 4 * ry2 * (2 * x + 3) - 8 * rx2 * (y - 1);
+            --y;
+        }
+        ++x;
+    }
+    // 区域 2：y 为主方向
+    d = ry2 * (2 * x + 1) * (2 * x + 1) + 4 * rx2 * (long long) (y - 1) * (y - 1) - 4 * rx2 * ry2;
+    while(y >= 0)
+    {
+        half_min[y] = std::min(half_min[y], x);
+        half_max[y] = std::max(half_max[y], x);
+        if(d > 0)
+            d += 4 * rx2 * (3 - 2 * y);
+        else
+        {
+            d += 8 * ry2 * (x + 1) + 4 * rx2 * (3 - 2 * y);
+            ++x;
+        }
+        --y;
+    }
+    for(int row = -ry; row <= ry; ++row)
+    {
+        int k = row < 0 ? -row : row;
+        if(half_max[k] < 0)
+            continue;
+        if(filled)
+            spans.push_back(Span{row, -half_max[k], half_max[k]});
+        else if(half_min[k] == 0)
+            spans.push_back(Span{row, -half_max[k], half_max[k]});
+        else
+        {
+            spans.push_back(Span{row, -half_max[k], -half_min[k]});
+            spans.push_back(Span{row, half_min[k], half_max[k]});
+        }
+    }
+}
+
+// 圆弧：从 start_degree 逆时针扫过 sweep_degree，只保留轮廓上角度落在范围内的像素
+inline void arcSpans(int r, float start_degree, float sweep_degree, std::vector<Span>& spans)
+{
+    std::vector<Span> outline;
+    bresenhamCircleSpans(0, 0, r, outline);
+    if(sweep_degree >= 360.0f || sweep_degree <= -360.0f)
+    {
+        spans.insert(spans.end(), outline.begin(), outline.end());
+        return;
+    }
+    if(sweep_degree < 0.0f)
+    {
+        start_degree += sweep_degree;
+        sweep_degree = -sweep_degree;
+    }
+    double start = std::fmod((double) start_degree, 360.0);
+    if(start < 0.0)
+        start += 360.0;
+    for(const Span& span : outline)
+        for(int x = span.x0; x <= span.x1; ++x)
+        {
+            double angle = std::atan2((double) span.y, (double) x) * 180.0 / M_PI - start;
+            angle = std::fmod(angle + 720.0, 360.0);
+            if(angle <= sweep_degree)
+                appendPixel(spans, x, span.y);
+        }
+}
+
+// 以形状参数为键缓存以原点为圆心的跨度，取用时再平移到圆心。
+// 参数不变时不重新生成，超过容量时淘汰最早加入的项
+class CircleCache {
+public:
+    enum Shape {
+        CIRCLE,
+        DISC,
+        ELLIPSE,
+        FILLED_ELLIPSE,
+        ARC
+    };
+
+    CircleCache(size_t capacity = 64):
+        capacity(capacity),
+        hits(0),
+        misses(0)
+    {
+    }
+    void circle(int c_x, int c_y, int r, bool filled, std::vector<Span>& spans)
+    {
+        append(lookup(Key{filled ? DISC : CIRCLE, r, r, 0.0f, 0.0f}), c_x, c_y, spans);
+    }
+    void ellipse(int c_x, int c_y, int rx, int ry, bool filled, std::vector<Span>& spans)
+    {
+        append(lookup(Key{filled ? FILLED_ELLIPSE : ELLIPSE, rx, ry, 0.0f, 0.0f}), c_x, c_y, spans);
+    }
+    void arc(int c_x, int c_y, int r, float start_degree, float sweep_degree, std::vector<Span>& spans)
+    {
+        append(lookup(Key{ARC, r, r, start_degree, sweep_degree}), c_x, c_y, spans);
+    }
+    size_t hitCount() const
+    {
+        return hits;
+    }
+    size_t missCount() const
+    {
+        return misses;
+    }
+    void clear()
+    {
+        entries.clear();
+        order.clear();
+    }
+private:
+    struct Key {
+        Shape shape;
+        int rx;
+        int ry;
+        float start;
+        float sweep;
+        bool operator<(const Key& other) const
+        {
+            if(shape != other.shape)
+                return shape < other.shape;
+            if(rx != other.rx)
+                return rx < other.rx;
+            if(ry != other.ry)
+                return ry < other.ry;
+            if(start != other.start)
+                return start < other.start;
+            return sweep < other.sweep;
+        }
+    };
+    size_t capacity;
+    size_t hits;
+    size_t misses;
+    std::map<Key, std::vector<Span>> entries;
+    std::deque<Key> order;
+
+    const std::vector<Span>& lookup(const Key& key)
+    {
+        auto found = entries.find(key);
+        if(found != entries.end())
+        {
+            ++hits;
+            return found->second;
+        }
+        ++misses;
+        if(entries.size() >= capacity && !order.empty())
+        {
+            entries.erase(order.front());
+            order.pop_front();
+        }
+        std::vector<Span>& spans = entries[key];
+        order.push_back(key);
+        switch(key.shape)
+        {
+            case CIRCLE:
+            case DISC:
+                circleSpans(key.rx, key.shape == DISC, spans);
+                break;
+            case ELLIPSE:
+            case FILLED_ELLIPSE:
+                ellipseSpans(key.rx, key.ry, key.shape == FILLED_ELLIPSE, spans);
+                break;
+            case ARC:
+                arcSpans(key.rx, key.start, key.sweep, spans);
+                break;
+        }
+        return spans;
+    }
+    static void append(const std::vector<Span>& cached, int c_x, int c_y, std::vector<Span>& spans)
+    {
+        for(const Span& span : cached)
+            spans.push_back(Span{span.y + c_y, span.x0 + c_x, span.x1 + c_x});
+    }
+};
+
+#endif /* Circle_h */
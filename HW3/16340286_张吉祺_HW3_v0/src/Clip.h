@@ -0,0 +1,294 @@
+//
+//  Clip.h
+//  CG
+//
+
+#ifndef Clip_h
+#define Clip_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Bresenham.h"
+#include "Rasterizer.h"
+#include "Span.h"
+
+struct ClipRect {
+    int x_min, y_min;
+    int x_max, y_max;
+};
+
+// 光栅化之前的裁剪。完全在视口外的图元直接丢弃；
+// 在视口外扩 guard_band 的保护带内的图元不裁剪，超出保护带的部分不会被生成。
+// 线段裁剪是精确的；三角形裁剪后的新顶点取整，边的位置可能偏差不到半个像素
+class Clipper {
+public:
+    enum OutCode {
+        INSIDE = 0,
+        LEFT = 1,
+        RIGHT = 2,
+        BOTTOM = 4,
+        TOP = 8
+    };
+
+    Clipper(ClipRect viewport, int guard_band = 0):
+        viewport(viewport),
+        guard(ClipRect{viewport.x_min - guard_band, viewport.y_min - guard_band,
+                       viewport.x_max + guard_band, viewport.y_max + guard_band}),
+        rejected(0),
+        clipped(0)
+    {
+    }
+
+    static int outCode(const ClipRect& rect, double x, double y)
+    {
+        int code = INSIDE;
+        if(x < rect.x_min)
+            code |= LEFT;
+        else if(x > rect.x_max)
+            code |= RIGHT;
+        if(y < rect.y_min)
+            code |= BOTTOM;
+        else if(y > rect.y_max)
+            code |= TOP;
+        return code;
+    }
+
+    // 线段：先用 Cohen–Sutherland 区域码整体接受或丢弃，跨边界的线段不移动端点
+    // （取整后的新端点会让 Bresenham 走出不同的像素），而是求出落在保护带内的步数区间
+    // [first, last]，光栅化时从 first 步直接开始，输出的像素与不裁剪时逐个相同
+    bool clipLine(const Segment& s, const BresenhamSetup& b, int& first, int& last)
+    {
+        first = 0;
+        last = b.delta_x - 1;
+        if(last < 0 || (outCode(viewport, s.x_start, s.y_start) & outCode(viewport, s.x_end, s.y_end)))
+        {
+            ++rejected;
+            return false;
+        }
+        if(!(outCode(guard, s.x_start, s.y_start) | outCode(guard, s.x_end, s.y_end)))
+            return true;
+        ++clipped;
+        // 像素的 x、y 都随步数单调，各自求出在保护带内的区间再取交集
+        limitSteps(b, true, guard.x_min, guard.x_max, first, last);
+        limitSteps(b, false, guard.y_min, guard.y_max, first, last);
+        if(first > last)
+        {
+            ++rejected;
+            return false;
+        }
+        return true;
+    }
+    // 批量裁剪并光栅化，只生成保护带内的像素，追加到 coordinates_xy
+    void lines(const Segment* segments, size_t count, std::vector<int>& coordinates_xy)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            const Segment& s = segments[i];
+            BresenhamSetup b(s.x_start, s.y_start, s.x_end, s.y_end);
+            int first, last;
+            if(!clipLine(s, b, first, last))
+                continue;
+            size_t offset = coordinates_xy.size();
+            coordinates_xy.resize(offset + 2 * (last - first + 1));
+            int* out = coordinates_xy.data() + offset;
+            bresenhamPlot(b, first, last, [&out](int x, int y)
+            {
+                *out++ = x;
+                *out++ = y;
+            });
+        }
+    }
+    void lineSpans(const Segment* segments, size_t count, std::vector<Span>& spans)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            const Segment& s = segments[i];
+            BresenhamSetup b(s.x_start, s.y_start, s.x_end, s.y_end);
+            int first, last;
+            if(clipLine(s, b, first, last))
+                bresenhamPlot(b, first, last, [&spans](int x, int y)
+                {
+                    appendPixel(spans, x, y);
+                });
+        }
+    }
+
+    // 圆：包围盒在视口外，或视口整个落在圆内（轮廓不可见）时返回 false
+    bool acceptCircle(int c_x, int c_y, int r, bool filled)
+    {
+        if(c_x + r < viewport.x_min || c_x - r > viewport.x_max ||
+           c_y + r < viewport.y_min || c_y - r > viewport.y_max)
+        {
+            ++rejected;
+            return false;
+        }
+        if(!filled)
+        {
+            double far_x = std::max(std::abs(viewport.x_min - c_x), std::abs(viewport.x_max - c_x));
+            double far_y = std::max(std::abs(viewport.y_min - c_y), std::abs(viewport.y_max - c_y));
+            if(std::sqrt(far_x * far_x + far_y * far_y) < r - 1)
+            {
+                ++rejected;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 三角形：完全在视口一侧则丢弃；包围盒在保护带内则原样保留；
+    // 否则对保护带做 Sutherland–Hodgman 裁剪，得到的凸多边形按扇形拆回三角形
+    void clipTriangle(const Triangle& t, std::vector<Triangle>& out)
+    {
+        int code1 = outCode(viewport, t.x1, t.y1);
+        int code2 = outCode(viewport, t.x2, t.y2);
+        int code3 = outCode(viewport, t.x3, t.y3);
+        if(code1 & code2 & code3)
+        {
+            ++rejected;
+            return;
+        }
+        if(!(outCode(guard, t.x1, t.y1) | outCode(guard, t.x2, t.y2) | outCode(guard, t.x3, t.y3)))
+        {
+            out.push_back(t);
+            return;
+        }
+        ++clipped;
+        polygon.clear();
+        polygon.push_back(Point{(double) t.x1, (double) t.y1});
+        polygon.push_back(Point{(double) t.x2, (double) t.y2});
+        polygon.push_back(Point{(double) t.x3, (double) t.y3});
+        for(int edge = 0; edge < 4 && !polygon.empty(); ++edge)
+            clipPolygon(edge);
+        for(size_t i = 2; i < polygon.size(); ++i)
+            out.push_back(Triangle{
+                (int) std::lround(polygon[0].x), (int) std::lround(polygon[0].y),
+                (int) std::lround(polygon[i - 1].x), (int) std::lround(polygon[i - 1].y),
+                (int) std::lround(polygon[i].x), (int) std::lround(polygon[i].y),
+                t.color});
+    }
+    void clipTriangles(const Triangle* triangles, size_t count, std::vector<Triangle>& out)
+    {
+        for(size_t i = 0; i < count; ++i)
+            clipTriangle(triangles[i], out);
+    }
+
+    // 跨度裁到视口，完全在外的去掉
+    void clipSpans(std::vector<Span>& spans)
+    {
+        size_t kept = 0;
+        for(size_t i = 0; i < spans.size(); ++i)
+        {
+            Span span = spans[i];
+            if(span.y < viewport.y_min || span.y > viewport.y_max)
+                continue;
+            span.x0 = std::max(span.x0, viewport.x_min);
+            span.x1 = std::min(span.x1, viewport.x_max);
+            if(span.x0 <= span.x1)
+                spans[kept++] = span;
+        }
+        spans.resize(kept);
+    }
+
+    size_t rejectedCount() const
+    {
+        return rejected;
+    }
+    size_t clippedCount() const
+    {
+        return clipped;
+    }
+private:
+    struct Point {
+        double x;
+        double y;
+    };
+    ClipRect viewport;
+    ClipRect guard;
+    size_t rejected;
+    size_t clipped;
+    std::vector<Point> polygon;
+    std::vector<Point> scratch;
+
+    static int coordinateAt(const BresenhamSetup& b, bool along_x, int i)
+    {
+        int x, y;
+        b.pixel(i, x, y);
+        return along_x ? x : y;
+    }
+    // 把 [first, last] 缩小到坐标落在 [low, high] 的步数，坐标对步数单调，二分查找
+    static void limitSteps(const BresenhamSetup& b, bool along_x, int low, int high, int& first, int& last)
+    {
+        if(first > last)
+            return;
+        bool increasing = coordinateAt(b, along_x, b.delta_x - 1) >= coordinateAt(b, along_x, 0);
+        // 第一个满足条件的步数
+        int lo = first, hi = last + 1;
+        while(lo < hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            int value = coordinateAt(b, along_x, mid);
+            if(increasing ? value >= low : value <= high)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        int new_first = lo;
+        // 最后一个满足条件的步数
+        lo = new_first - 1;
+        hi = last;
+        while(lo < hi)
+        {
+            int mid = hi - (hi - lo) / 2;
+            int value = coordinateAt(b, along_x, mid);
+            if(increasing ? value <= high : value >= low)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        first = new_first;
+        last = lo;
+    }
+    // edge: 0 左 1 右 2 下 3 上
+    bool inside(const Point& p, int edge) const
+    {
+        switch(edge)
+        {
+            case 0: return p.x >= guard.x_min;
+            case 1: return p.x <= guard.x_max;
+            case 2: return p.y >= guard.y_min;
+            default: return p.y <= guard.y_max;
+        }
+    }
+    Point intersect(const Point& p, const Point& q, int edge) const
+    {
+        double t;
+        if(edge < 2)
+        {
+            double x = edge == 0 ? guard.x_min : guard.x_max;
+            t = (x - p.x) / (q.x - p.x);
+            return Point{x, p.y + t * (q.y - p.y)};
+        }
+        double y = edge == 2 ? guard.y_min : guard.y_max;
+        t = (y - p.y) / (q.y - p.y);
+        return Point{p.x + t * (q.x - p.x), y};
+    }
+    void clipPolygon(int edge)
+    {
+        scratch.clear();
+        for(size_t i = 0; i < polygon.size(); ++i)
+        {
+            const Point& p = polygon[i];
+            const Point& q = polygon[(i + 1) % polygon.size()];
+            bool p_in = inside(p, edge);
+            bool q_in = inside(q, edge);
+            if(p_in)
+                scratch.push_back(p);
+            if(p_in != q_in)
+                scratch.push_back(intersect(p, q, edge));
+        }
+        polygon.swap(scratch);
+    }
+};
+
+#endif /* Clip_h */
@@ -0,0 +1,224 @@
+//
+//  Headless.cpp
+//  CG
+//
+//  不创建窗口、不需要 GPU，用 Pipeline 渲染 HW6 的光照立方体场景并写出 PPM。
+//  用法：Headless [output.ppm] [frames] [threads] [gouraud]
+//  frames > 1 时光源按 HW6 的 Encircle 绕立方体旋转（每帧 1/60 秒），输出最后一帧
+//
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "Pipeline.h"
+
+const uint SCR_WIDTH = 800;
+const uint SCR_HEIGHT = 600;
+
+// HW6 的 cubeVertexShaderSource / cubeFragmentShaderSource 等价的 uniform
+struct CubeUniforms {
+    glm::mat4 model;
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat3 normal_matrix;
+    glm::vec3 lightPos;
+    glm::vec3 lightColor;
+    glm::vec3 objectColor;
+    glm::vec3 viewPos;
+    float ambientStrength;
+    float diffuseStrength;
+    float specularStrength;
+    float shininess;
+};
+
+glm::vec3 phong(const CubeUniforms& u, const glm::vec3& FragPos, const glm::vec3& Normal, float shininess)
+{
+    glm::vec3 ambient = u.ambientStrength * u.lightColor;
+    glm::vec3 norm = glm::normalize(Normal);
+    glm::vec3 lightDir = glm::normalize(u.lightPos - FragPos);
+    float diff = std::max(glm::dot(norm, lightDir), 0.0f);
+    glm::vec3 diffuse = u.diffuseStrength * diff * u.lightColor;
+    glm::vec3 viewDir = glm::normalize(u.viewPos - FragPos);
+    glm::vec3 reflectDir = glm::reflect(-lightDir, norm);
+    float spec = std::pow(std::max(glm::dot(viewDir, reflectDir), 0.0f), shininess);
+    glm::vec3 specular = u.specularStrength * spec * u.lightColor;
+    return (ambient + diffuse + specular) * u.objectColor;
+}
+
+// out: FragPos (3), Normal (3)
+void cubeVertex(const CubeUniforms& u, const float* attributes, ShadedVertex& out)
+{
+    glm::vec3 aPos(attributes[0], attributes[1], attributes[2]);
+    glm::vec3 aNormal(attributes[3], attributes[4], attributes[5]);
+    glm::vec3 FragPos = glm::vec3(u.model * glm::vec4(aPos, 1.0f));
+    glm::vec3 Normal = u.normal_matrix * aNormal;
+    out.position = u.projection * u.view * glm::vec4(FragPos, 1.0f);
+    for(int i = 0; i < 3; ++i)
+    {
+        out.varyings[i] = FragPos[i];
+        out.varyings[3 + i] = Normal[i];
+    }
+}
+
+glm::vec4 cubeFragment(const CubeUniforms& u, const float* varyings)
+{
+    glm::vec3 FragPos(varyings[0], varyings[1], varyings[2]);
+    glm::vec3 Normal(varyings[3], varyings[4], varyings[5]);
+    return glm::vec4(phong(u, FragPos, Normal, u.shininess), 1.0f);
+}
+
+// Gouraud：光照在顶点上计算，out: vertexColor (3)。与 HW6 一致，高光指数固定为 32
+void cubeGouraudVertex(const CubeUniforms& u, const float* attributes, ShadedVertex& out)
+{
+    glm::vec3 aPos(attributes[0], attributes[1], attributes[2]);
+    glm::vec3 aNormal(attributes[3], attributes[4], attributes[5]);
+    glm::vec3 FragPos = glm::vec3(u.model * glm::vec4(aPos, 1.0f));
+    out.position = u.projection * u.view * glm::vec4(FragPos, 1.0f);
+    glm::vec3 vertexColor = phong(u, FragPos, u.normal_matrix * aNormal, 32.0f);
+    for(int i = 0; i < 3; ++i)
+        out.varyings[i] = vertexColor[i];
+}
+
+glm::vec4 cubeGouraudFragment(const float* varyings)
+{
+    return glm::vec4(varyings[0], varyings[1], varyings[2], 1.0f);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* output = argc > 1 ? argv[1] : "cube.ppm";
+    int frames = argc > 2 ? std::max(atoi(argv[2]), 1) : 1;
+    unsigned threads = argc > 3 && atoi(argv[3]) > 0 ? (unsigned) atoi(argv[3]) : std::thread::hardware_concurrency();
+    bool gouraud = argc > 4 && strcmp(argv[4], "gouraud") == 0;
+
+    float vertices[] =
+    {
+        -2.0f, -2.0f, -2.0f,  0.0f,  0.0f, -1.0f,
+         2.0f, -2.0f, -2.0f,  0.0f,  0.0f, -1.0f,
+         2.0f,  2.0f, -2.0f,  0.0f,  0.0f, -1.0f,
+         2.0f,  2.0f, -2.0f,  0.0f,  0.0f, -1.0f,
+        -2.0f,  2.0f, -2.0f,  0.0f,  0.0f, -1.0f,
+        -2.0f, -2.0f, -2.0f,  0.0f,  0.0f, -1.0f,
+
+        -2.0f, -2.0f,  2.0f,  0.0f,  0.0f,  1.0f,
+         2.0f, -2.0f,  2.0f,  0.0f,  0.0f,  1.0f,
+         2.0f,  2.0f,  2.0f,  0.0f,  0.0f,  1.0f,
+         2.0f,  2.0f,  2.0f,  0.0f,  0.0f,  1.0f,
+        -2.0f,  2.0f,  2.0f,  0.0f,  0.0f,  1.0f,
+        -2.0f, -2.0f,  2.0f,  0.0f,  0.0f,  1.0f,
+
+        -2.0f,  2.0f,  2.0f, -1.0f,  0.0f,  0.0f,
+        -2.0f,  2.0f, -2.0f, -1.0f,  0.0f,  0.0f,
+        -2.0f, -2.0f, -2.0f, -1.0f,  0.0f,  0.0f,
+        -2.0f, -2.0f, -2.0f, -1.0f,  0.0f,  0.0f,
+        -2.0f, -2.0f,  2.0f, -1.0f,  0.0f,  0.0f,
+        -2.0f,  2.0f,  2.0f, -1.0f,  0.0f,  0.0f,
+
+         2.0f,  2.0f,  2.0f,  1.0f,  0.0f,  0.0f,
+         2.0f,  2.0f, -2.0f,  1.0f,  0.0f,  0.0f,
+         2.0f, -2.0f, -2.0f,  1.0f,  0.0f,  0.0f,
+         2.0f, -2.0f, -2.0f,  1.0f,  0.0f,  0.0f,
+         2.0f, -2.0f,  2.0f,  1.0f,  0.0f,  0.0f,
+         2.0f,  2.0f,  2.0f,  1.0f,  0.0f,  0.0f,
+
+        -2.0f, -2.0f, -2.0f,  0.0f, -1.0f,  0.0f,
+         2.0f, -2.0f, -2.0f,  0.0f, -1.0f,  0.0f,
+         2.0f, -2.0f,  2.0f,  0.0f, -1.0f,  0.0f,
+         2.0f, -2.0f,  2.0f,  0.0f, -1.0f,  0.0f,
+        -2.0f, -2.0f,  2.0f,  0.0f, -1.0f,  0.0f,
+        -2.0f, -2.0f, -2.0f,  0.0f, -1.0f,  0.0f,
+
+        -2.0f,  2.0f, -2.0f,  0.0f,  1.0f,  0.0f,
+         2.0f,  2.0f, -2.0f,  0.0f,  1.0f,  0.0f,
+         2.0f,  2.0f,  2.0f,  0.0f,  1.0f,  0.0f,
+         2.0f,  2.0f,  2.0f,  0.0f,  1.0f,  0.0f,
+        -2.0f,  2.0f,  2.0f,  0.0f,  1.0f,  0.0f,
+        -2.0f,  2.0f, -2.0f,  0.0f,  1.0f,  0.0f
+    };
+
+    Pipeline pipeline(threads);
+    RenderTarget target(SCR_WIDTH, SCR_HEIGHT);
+
+    // 与 HW6 的默认参数相同，相机即 Camera(glm::vec3(8.0f, -8.0f, 10.0f)).getView()
+    CubeUniforms u;
+    u.ambientStrength = 0.1f;
+    u.diffuseStrength = 1.0f;
+    u.specularStrength = 0.5f;
+    u.shininess = 32.0f;
+    u.objectColor = glm::vec3(1.0f, 0.5f, 0.31f);
+    u.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    u.lightPos = glm::vec3(-5.0f, -5.0f, 5.0f);
+    u.viewPos = glm::vec3(8.0f, -8.0f, 10.0f);
+    u.view = glm::lookAt(u.viewPos, u.viewPos + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    u.projection = glm::perspective(45.0f, (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 100.0f);
+
+    size_t fragments = 0, rejected_blocks = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int frame = 0; frame < frames; ++frame)
+    {
+        if(frames > 1)
+        {
+            float radius = 5.0f;
+            float time = frame / 60.0f;
+            u.lightPos = glm::vec3(sin(time) * radius, -5.0f, cos(time) * radius);
+        }
+        target.clear();
+
+        u.model = glm::mat4(1.0f);
+        u.normal_matrix = glm::mat3(glm::transpose(glm::inverse(u.model)));
+        if(gouraud)
+        {
+            pipeline.setVertexFunction([&u](const float* attributes, ShadedVertex& out)
+            {
+                cubeGouraudVertex(u, attributes, out);
+            }, 3);
+            pipeline.setFragmentFunction(cubeGouraudFragment);
+        }
+        else
+        {
+            pipeline.setVertexFunction([&u](const float* attributes, ShadedVertex& out)
+            {
+                cubeVertex(u, attributes, out);
+            }, 6);
+            pipeline.setFragmentFunction([&u](const float* varyings)
+            {
+                return cubeFragment(u, varyings);
+            });
+        }
+        pipeline.drawArrays(vertices, 6, 36, target);
+        fragments += pipeline.fragmentCount();
+        rejected_blocks += pipeline.rejectedBlockCount();
+
+        // 光源立方体
+        glm::mat4 light_model = glm::scale(glm::translate(glm::mat4(1.0f), u.lightPos), glm::vec3(0.2f));
+        glm::mat4 light_mvp = u.projection * u.view * light_model;
+        pipeline.setVertexFunction([&light_mvp](const float* attributes, ShadedVertex& out)
+        {
+            out.position = light_mvp * glm::vec4(attributes[0], attributes[1], attributes[2], 1.0f);
+        }, 0);
+        pipeline.setFragmentFunction([](const float*)
+        {
+            return glm::vec4(1.0f);
+        });
+        pipeline.drawArrays(vertices, 6, 36, target);
+        fragments += pipeline.fragmentCount();
+        rejected_blocks += pipeline.rejectedBlockCount();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << frames << " frame(s), " << pipeline.threadCount() << " thread(s), "
+              << seconds * 1000.0 / frames << " ms/frame, "
+              << fragments / frames << " fragments/frame, "
+              << rejected_blocks / frames << " Hi-Z blocks rejected/frame" << std::endl;
+    if(!target.writePPM(output))
+    {
+        std::cout << "Failed to write " << output << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,572 @@
+//
+//  Pipeline.h
+//  CG
+//
+
+#ifndef Pipeline_h
+#define Pipeline_h
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "Rasterizer.h"
+
+// 不依赖 GPU 的三角形管线，流程与 OpenGL 相同：
+// 顶点函数 -> 图元装配 -> 齐次空间裁剪 -> 透视除法和视口变换 -> 分块光栅化 -> 深度测试 -> 片元函数。
+// 顶点函数、片元函数对应 GLSL 的 vertex / fragment shader，uniform 由调用方在函数对象里捕获
+
+// 顶点函数的输出：gl_Position 和最多 MAX_VARYINGS 个 float 的 out 变量
+struct ShadedVertex {
+    static const int MAX_VARYINGS = 16;
+    glm::vec4 position;
+    float varyings[MAX_VARYINGS];
+};
+
+// attributes 指向一个顶点的属性（与 glVertexAttribPointer 的布局一致）
+typedef std::function<void(const float* attributes, ShadedVertex& out)> VertexFunction;
+// varyings 为透视校正插值后的 out 变量，返回 FragColor
+typedef std::function<glm::vec4(const float* varyings)> FragmentFunction;
+
+// 颜色按 0xAABBGGRR 存放，与 glReadPixels(GL_RGBA, GL_UNSIGNED_BYTE) 的字节顺序相同
+inline uint32_t packColor(const glm::vec4& color)
+{
+    uint32_t result = 0;
+    for(int i = 0; i < 4; ++i)
+    {
+        float channel = std::min(std::max(color[i], 0.0f), 1.0f);
+        result |= (uint32_t) (channel * 255.0f + 0.5f) << (8 * i);
+    }
+    return result;
+}
+
+// 颜色缓冲和深度缓冲，像素 (x, y) 以左下角为原点，与 glViewport(0, 0, width, height) 一致。
+// 另有一层 HIZ_BLOCK x HIZ_BLOCK 块的深度范围（Hi-Z），由 Pipeline 在写深度时维护，
+// block_min / block_max 为块内深度的下界和上界
+struct RenderTarget {
+    static const int HIZ_BLOCK = 8;
+
+    int width;
+    int height;
+    int blocks_x;
+    int blocks_y;
+    std::vector<uint32_t> color;
+    std::vector<float> depth;
+    std::vector<float> block_min;
+    std::vector<float> block_max;
+
+    RenderTarget(int width, int height):
+        width(width),
+        height(height),
+        blocks_x((width + HIZ_BLOCK - 1) / HIZ_BLOCK),
+        blocks_y((height + HIZ_BLOCK - 1) / HIZ_BLOCK),
+        color((size_t) width * height),
+        depth((size_t) width * height),
+        block_min((size_t) blocks_x * blocks_y),
+        block_max((size_t) blocks_x * blocks_y)
+    {
+    }
+    // 相当于 glClearColor + glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT)
+    void clear(const glm::vec4& clear_color = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), float clear_depth = 1.0f)
+    {
+        std::fill(color.begin(), color.end(), packColor(clear_color));
+        std::fill(depth.begin(), depth.end(), clear_depth);
+        std::fill(block_min.begin(), block_min.end(), clear_depth);
+        std::fill(block_max.begin(), block_max.end(), clear_depth);
+    }
+    // 以左下角为原点的 Framebuffer，可以直接用 fillSpans / blendCoverage 叠加二维图元
+    Framebuffer framebuffer()
+    {
+        return Framebuffer{color.data(), width, height, 0, 0};
+    }
+    // 写出二进制 PPM，第一行是屏幕最上方
+    bool writePPM(const char* path) const
+    {
+        FILE* file = fopen(path, "wb");
+        if(!file)
+            return false;
+        fprintf(file, "P6\n%d %d\n255\n", width, height);
+        std::vector<unsigned char> row(3 * (size_t) width);
+        for(int y = height - 1; y >= 0; --y)
+        {
+            for(int x = 0; x < width; ++x)
+            {
+                uint32_t pixel = color[(size_t) y * width + x];
+                row[3 * x] = pixel & 0xFF;
+                row[3 * x + 1] = (pixel >> 8) & 0xFF;
+                row[3 * x + 2] = (pixel >> 16) & 0xFF;
+            }
+            fwrite(row.data(), 1, row.size(), file);
+        }
+        return fclose(file) == 0;
+    }
+};
+
+class Pipeline {
+public:
+    static const int TILE_SIZE = 64;
+    // 屏幕坐标的亚像素精度，与常见 GPU 一样取 4 位
+    static const int SUBPIXEL_BITS = 4;
+    // x、y 超出视口 GUARD_BAND 倍范围的三角形才做裁剪，其余的交给光栅化时的包围盒限制
+    static constexpr float GUARD_BAND = 2.0f;
+    // Hi-Z 比较时深度范围放宽的量，抵消块的平面估计和逐像素插值之间的舍入误差，
+    // 保证整块丢弃或跳过深度测试的结果与逐像素测试相同
+    static constexpr float DEPTH_EPSILON = 1e-5f;
+    static_assert(TILE_SIZE % RenderTarget::HIZ_BLOCK == 0, "Hi-Z blocks must not straddle tiles");
+
+    Pipeline(unsigned threads = std::thread::hardware_concurrency()):
+        pool(threads),
+        varying_count(0),
+        cull_back_faces(false),
+        hierarchical_depth(true),
+        target(NULL),
+        tiles_x(0),
+        tiles_y(0)
+    {
+    }
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // varying_count 为顶点函数写出的 out 变量个数
+    void setVertexFunction(const VertexFunction& function, int varying_count)
+    {
+        vertex_function = function;
+        this->varying_count = std::min(varying_count, (int) ShadedVertex::MAX_VARYINGS);
+    }
+    void setFragmentFunction(const FragmentFunction& function)
+    {
+        fragment_function = function;
+    }
+    // 相当于 glEnable(GL_CULL_FACE)，逆时针为正面
+    void setCullBackFaces(bool cull)
+    {
+        cull_back_faces = cull;
+    }
+    // 是否使用 Hi-Z 整块丢弃 / 整块接受，关闭后逐像素测试，用于对比
+    void setHierarchicalDepth(bool enable)
+    {
+        hierarchical_depth = enable;
+    }
+
+    // 相当于 glDrawArrays(GL_TRIANGLES, 0, count)，每个顶点占 stride 个 float。
+    // 深度测试为 GL_LESS，同一块内的三角形按提交顺序绘制，结果与线程数无关
+    void drawArrays(const float* attributes, int stride, size_t count, RenderTarget& render_target)
+    {
+        count -= count % 3;
+        if(count == 0 || !vertex_function || !fragment_function ||
+           render_target.width <= 0 || render_target.height <= 0)
+            return;
+        target = &render_target;
+        shadeVertices(attributes, stride, count);
+        triangles.clear();
+        for(size_t i = 0; i < count; i += 3)
+            assemble(shaded[i], shaded[i + 1], shaded[i + 2]);
+        binTriangles();
+        next_tile.store(0);
+        pool.run([this] { processTiles(); });
+    }
+
+    // 最近一次 drawArrays 裁剪后进入光栅化的三角形数
+    size_t triangleCount() const
+    {
+        return triangles.size();
+    }
+    // 以下统计均针对最近一次 drawArrays。
+    // 执行片元函数的次数
+    size_t fragmentCount() const
+    {
+        return total(&TileStats::fragments);
+    }
+    // 三角形覆盖到的 Hi-Z 块数（三角形与块的组合，同一块被多个三角形覆盖时分别计数）
+    size_t testedBlockCount() const
+    {
+        return total(&TileStats::tested_blocks);
+    }
+    // 三角形在块内的深度下界不小于块的深度上界，整块跳过的次数
+    size_t rejectedBlockCount() const
+    {
+        return total(&TileStats::rejected_blocks);
+    }
+    // 三角形完全覆盖整块且整块都在已有深度之前，跳过逐像素覆盖和深度测试的次数
+    size_t acceptedBlockCount() const
+    {
+        return total(&TileStats::accepted_blocks);
+    }
+    unsigned threadCount() const
+    {
+        return pool.threadCount();
+    }
+private:
+    // 视口变换后的三角形：顶点为定点数屏幕坐标，varyings 预先乘以 1 / w
+    struct ScreenTriangle {
+        int64_t x[3];
+        int64_t y[3];
+        float z[3];
+        float inv_w[3];
+        float varyings[3][ShadedVertex::MAX_VARYINGS];
+        int min_x, min_y, max_x, max_y;
+    };
+    // 各块单独计数，工作线程之间不共享计数器
+    struct TileStats {
+        size_t fragments;
+        size_t tested_blocks;
+        size_t rejected_blocks;
+        size_t accepted_blocks;
+    };
+    // 一个三角形在当前块内的边函数增量和左上规则偏移
+    struct EdgeSteps {
+        int64_t step_x[3];
+        int64_t step_y[3];
+        int64_t bias[3];
+        float inv_area;
+
+        bool inside(const int64_t w[3]) const
+        {
+            return ((w[0] - bias[0]) | (w[1] - bias[1]) | (w[2] - bias[2])) >= 0;
+        }
+    };
+
+    WorkerPool pool;
+    VertexFunction vertex_function;
+    FragmentFunction fragment_function;
+    int varying_count;
+    bool cull_back_faces;
+    bool hierarchical_depth;
+
+    RenderTarget* target;
+    std::atomic<size_t> next_vertex;
+    std::atomic<int> next_tile;
+    int tiles_x;
+    int tiles_y;
+    // 以下数组在各次绘制之间复用，稳定后不再分配内存
+    std::vector<ShadedVertex> shaded;
+    std::vector<ScreenTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;
+    std::vector<TileStats> tile_stats;
+    std::vector<ShadedVertex> polygon;
+    std::vector<ShadedVertex> scratch;
+
+    // 顶点阶段：各线程按块领取顶点
+    void shadeVertices(const float* attributes, int stride, size_t count)
+    {
+        const size_t chunk = 256;
+        shaded.resize(count);
+        next_vertex.store(0);
+        pool.run([this, attributes, stride, count, chunk]
+        {
+            for(size_t first = next_vertex.fetch_add(chunk); first < count; first = next_vertex.fetch_add(chunk))
+                for(size_t i = first; i < std::min(first + chunk, count); ++i)
+                    vertex_function(attributes + i * stride, shaded[i]);
+        });
+    }
+
+    // 裁剪平面 plane(v) >= 0 为内侧：0..3 为 x、y 的保护带，4、5 为近、远平面
+    static float planeDistance(const glm::vec4& p, int plane)
+    {
+        switch(plane)
+        {
+            case 0: return GUARD_BAND * p.w + p.x;
+            case 1: return GUARD_BAND * p.w - p.x;
+            case 2: return GUARD_BAND * p.w + p.y;
+            case 3: return GUARD_BAND * p.w - p.y;
+            case 4: return p.w + p.z;
+            default: return p.w - p.z;
+        }
+    }
+    ShadedVertex lerp(const ShadedVertex& p, const ShadedVertex& q, float t) const
+    {
+        ShadedVertex v;
+        v.position = p.position + (q.position - p.position) * t;
+        for(int k = 0; k < varying_count; ++k)
+            v.varyings[k] = p.varyings[k] + (q.varyings[k] - p.varyings[k]) * t;
+        return v;
+    }
+    // 图元装配：整个在某个平面外侧的丢弃，跨平面的做 Sutherland–Hodgman 裁剪后按扇形拆分
+    void assemble(const ShadedVertex& a, const ShadedVertex& b, const ShadedVertex& c)
+    {
+        int outside_all = 0x3F;
+        int outside_any = 0;
+        const ShadedVertex* vertices[3] = {&a, &b, &c};
+        for(int i = 0; i < 3; ++i)
+        {
+            int code = 0;
+            for(int plane = 0; plane < 6; ++plane)
+                if(planeDistance(vertices[i]->position, plane) < 0.0f)
+                    code |= 1 << plane;
+            outside_all &= code;
+            outside_any |= code;
+        }
+        if(outside_all)
+            return;
+        if(!outside_any)
+        {
+            setupTriangle(a, b, c);
+            return;
+        }
+        polygon.assign({a, b, c});
+        for(int plane = 0; plane < 6 && !polygon.empty(); ++plane)
+        {
+            if(!(outside_any & (1 << plane)))
+                continue;
+            scratch.clear();
+            for(size_t i = 0; i < polygon.size(); ++i)
+            {
+                const ShadedVertex& p = polygon[i];
+                const ShadedVertex& q = polygon[(i + 1) % polygon.size()];
+                float d_p = planeDistance(p.position, plane);
+                float d_q = planeDistance(q.position, plane);
+                if(d_p >= 0.0f)
+                    scratch.push_back(p);
+                if((d_p >= 0.0f) != (d_q >= 0.0f))
+                    scratch.push_back(lerp(p, q, d_p / (d_p - d_q)));
+            }
+            polygon.swap(scratch);
+        }
+        for(size_t i = 2; i < polygon.size(); ++i)
+            setupTriangle(polygon[0], polygon[i - 1], polygon[i]);
+    }
+    // 透视除法、视口变换，按面积去掉退化和背面的三角形，统一为逆时针
+    void setupTriangle(const ShadedVertex& a, const ShadedVertex& b, const ShadedVertex& c)
+    {
+        const ShadedVertex* vertices[3] = {&a, &b, &c};
+        ScreenTriangle t;
+        const float scale = (float) (1 << SUBPIXEL_BITS);
+        for(int i = 0; i < 3; ++i)
+        {
+            const glm::vec4& p = vertices[i]->position;
+            float inv_w = 1.0f / p.w;
+            t.x[i] = (int64_t) std::lround((p.x * inv_w * 0.5f + 0.5f) * target->width * scale);
+            t.y[i] = (int64_t) std::lround((p.y * inv_w * 0.5f + 0.5f) * target->height * scale);
+            t.z[i] = p.z * inv_w * 0.5f + 0.5f;
+            t.inv_w[i] = inv_w;
+            for(int k = 0; k < varying_count; ++k)
+                t.varyings[i][k] = vertices[i]->varyings[k] * inv_w;
+        }
+        int64_t area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.y[1] - t.y[0]) * (t.x[2] - t.x[0]);
+        if(area == 0 || (area < 0 && cull_back_faces))
+            return;
+        if(area < 0)
+        {
+            std::swap(t.x[1], t.x[2]);
+            std::swap(t.y[1], t.y[2]);
+            std::swap(t.z[1], t.z[2]);
+            std::swap(t.inv_w[1], t.inv_w[2]);
+            std::swap(t.varyings[1], t.varyings[2]);
+        }
+        // 覆盖的像素中心 (x + 0.5, y + 0.5) 的范围
+        const int64_t half = 1 << (SUBPIXEL_BITS - 1);
+        int64_t min_x = std::min(t.x[0], std::min(t.x[1], t.x[2]));
+        int64_t min_y = std::min(t.y[0], std::min(t.y[1], t.y[2]));
+        int64_t max_x = std::max(t.x[0], std::max(t.x[1], t.x[2]));
+        int64_t max_y = std::max(t.y[0], std::max(t.y[1], t.y[2]));
+        t.min_x = std::max((int) ((min_x - half + (1 << SUBPIXEL_BITS) - 1) >> SUBPIXEL_BITS), 0);
+        t.min_y = std::max((int) ((min_y - half + (1 << SUBPIXEL_BITS) - 1) >> SUBPIXEL_BITS), 0);
+        t.max_x = std::min((int) ((max_x - half) >> SUBPIXEL_BITS), target->width - 1);
+        t.max_y = std::min((int) ((max_y - half) >> SUBPIXEL_BITS), target->height - 1);
+        if(t.min_x > t.max_x || t.min_y > t.max_y)
+            return;
+        triangles.push_back(t);
+    }
+    void binTriangles()
+    {
+        tiles_x = (target->width + TILE_SIZE - 1) / TILE_SIZE;
+        tiles_y = (target->height + TILE_SIZE - 1) / TILE_SIZE;
+        if(bins.size() < (size_t) (tiles_x * tiles_y))
+            bins.resize(tiles_x * tiles_y);
+        for(auto& bin : bins)
+            bin.clear();
+        tile_stats.assign(tiles_x * tiles_y, TileStats{0, 0, 0, 0});
+        for(size_t i = 0; i < triangles.size(); ++i)
+        {
+            const ScreenTriangle& t = triangles[i];
+            for(int ty = t.min_y / TILE_SIZE; ty <= t.max_y / TILE_SIZE; ++ty)
+                for(int tx = t.min_x / TILE_SIZE; tx <= t.max_x / TILE_SIZE; ++tx)
+                    bins[ty * tiles_x + tx].push_back((uint32_t) i);
+        }
+    }
+    void processTiles()
+    {
+        int tile_count = tiles_x * tiles_y;
+        for(int tile = next_tile++; tile < tile_count; tile = next_tile++)
+        {
+            int x0 = (tile % tiles_x) * TILE_SIZE;
+            int y0 = (tile / tiles_x) * TILE_SIZE;
+            int x1 = std::min(x0 + TILE_SIZE, target->width) - 1;
+            int y1 = std::min(y0 + TILE_SIZE, target->height) - 1;
+            for(uint32_t index : bins[tile])
+                rasterize(triangles[index], x0, y0, x1, y1, tile_stats[tile]);
+        }
+    }
+    size_t total(size_t TileStats::*field) const
+    {
+        size_t sum = 0;
+        for(const TileStats& stats : tile_stats)
+            sum += stats.*field;
+        return sum;
+    }
+    // 在 [x0, x1] x [y0, y1] 内光栅化。
+    // 边函数用定点整数计算，共享边上的像素按左上规则只属于一个三角形。
+    // 按 Hi-Z 块逐块处理：深度平面在块上的范围先与块的深度范围比较，
+    // 整块被挡住的直接跳过，整块可见且完全覆盖的不做逐像素测试
+    void rasterize(const ScreenTriangle& t, int x0, int y0, int x1, int y1, TileStats& stats)
+    {
+        int x_start = std::max(x0, t.min_x);
+        int x_end = std::min(x1, t.max_x);
+        int y_start = std::max(y0, t.min_y);
+        int y_end = std::min(y1, t.max_y);
+        if(x_start > x_end || y_start > y_end)
+            return;
+        // 边 i 从顶点 i 到顶点 i + 1，E_i 对应对面顶点 i + 2 的重心坐标
+        EdgeSteps edges;
+        int64_t origin[3];
+        const int64_t one = 1 << SUBPIXEL_BITS;
+        const int64_t sample_x = ((int64_t) x_start << SUBPIXEL_BITS) + one / 2;
+        const int64_t sample_y = ((int64_t) y_start << SUBPIXEL_BITS) + one / 2;
+        for(int i = 0; i < 3; ++i)
+        {
+            int j = (i + 1) % 3;
+            int64_t dx = t.x[j] - t.x[i];
+            int64_t dy = t.y[j] - t.y[i];
+            edges.step_x[i] = -dy * one;
+            edges.step_y[i] = dx * one;
+            origin[i] = dx * (sample_y - t.y[i]) - dy * (sample_x - t.x[i]);
+            // 左边（向下）和上边（水平向左）上的像素算作内部
+            edges.bias[i] = (dy < 0 || (dy == 0 && dx < 0)) ? 0 : 1;
+        }
+        // 三个边函数之和恒等于两倍面积，与像素位置无关
+        edges.inv_area = 1.0f / (float) (origin[0] + origin[1] + origin[2]);
+        // 深度是屏幕空间的平面，z(x_start, y_start) 和每像素的梯度
+        float z_origin = (origin[1] * t.z[0] + origin[2] * t.z[1] + origin[0] * t.z[2]) * edges.inv_area;
+        float dz_dx = (edges.step_x[1] * t.z[0] + edges.step_x[2] * t.z[1] + edges.step_x[0] * t.z[2]) * edges.inv_area;
+        float dz_dy = (edges.step_y[1] * t.z[0] + edges.step_y[2] * t.z[1] + edges.step_y[0] * t.z[2]) * edges.inv_area;
+        float z_low = std::min(t.z[0], std::min(t.z[1], t.z[2]));
+        float z_high = std::max(t.z[0], std::max(t.z[1], t.z[2]));
+
+        const int block_size = RenderTarget::HIZ_BLOCK;
+        for(int by = y_start / block_size * block_size; by <= y_end; by += block_size)
+            for(int bx = x_start / block_size * block_size; bx <= x_end; bx += block_size)
+            {
+                // 块在帧缓冲内的部分，以及其中属于三角形包围盒的部分
+                int block_x1 = std::min(bx + block_size, target->width) - 1;
+                int block_y1 = std::min(by + block_size, target->height) - 1;
+                int px0 = std::max(bx, x_start);
+                int px1 = std::min(block_x1, x_end);
+                int py0 = std::max(by, y_start);
+                int py1 = std::min(block_y1, y_end);
+                int64_t w[3];
+                for(int i = 0; i < 3; ++i)
+                    w[i] = origin[i] + edges.step_x[i] * (px0 - x_start) + edges.step_y[i] * (py0 - y_start);
+                size_t block = (size_t) (by / block_size) * target->blocks_x + bx / block_size;
+                bool accept = false;
+                if(hierarchical_depth)
+                {
+                    ++stats.tested_blocks;
+                    // 平面在矩形上的极值在角上取得，再限制在三角形自身的深度范围内
+                    float z_corner = z_origin + dz_dx * (px0 - x_start) + dz_dy * (py0 - y_start);
+                    float span_x = dz_dx * (px1 - px0);
+                    float span_y = dz_dy * (py1 - py0);
+                    float z_min = std::max(z_corner + std::min(span_x, 0.0f) + std::min(span_y, 0.0f), z_low);
+                    float z_max = std::min(z_corner + std::max(span_x, 0.0f) + std::max(span_y, 0.0f), z_high);
+                    if(z_min - DEPTH_EPSILON >= target->block_max[block])
+                    {
+                        ++stats.rejected_blocks;
+                        continue;
+                    }
+                    // 三角形是凸的，矩形四个角都在内部则整个矩形在内部
+                    if(px0 == bx && px1 == block_x1 && py0 == by && py1 == block_y1 &&
+                       z_max + DEPTH_EPSILON < target->block_min[block])
+                    {
+                        int64_t dx = px1 - px0, dy = py1 - py0;
+                        int64_t corner[3];
+                        accept = true;
+                        for(int k = 0; k < 4 && accept; ++k)
+                        {
+                            for(int i = 0; i < 3; ++i)
+                                corner[i] = w[i] + (k & 1 ? edges.step_x[i] * dx : 0) + (k & 2 ? edges.step_y[i] * dy : 0);
+                            accept = edges.inside(corner);
+                        }
+                    }
+                }
+                float written_min = 1.0f, written_max = 0.0f;
+                if(accept)
+                {
+                    ++stats.accepted_blocks;
+                    stats.fragments += shadeRect<false>(t, edges, w, px0, py0, px1, py1, written_min, written_max);
+                    // 整块都被覆盖，新的范围就是写入的范围
+                    target->block_min[block] = written_min;
+                    target->block_max[block] = written_max;
+                    continue;
+                }
+                size_t fragments = shadeRect<true>(t, edges, w, px0, py0, px1, py1, written_min, written_max);
+                stats.fragments += fragments;
+                if(fragments)
+                    updateBlock(block, bx, by, block_x1, block_y1);
+            }
+    }
+    // 对 [px0, px1] x [py0, py1] 内的像素执行片元函数，w 为三条边在 (px0, py0) 的值。
+    // TEST 为 false 时调用方已保证所有像素都被覆盖且通过深度测试
+    template <bool TEST>
+    size_t shadeRect(const ScreenTriangle& t, const EdgeSteps& edges, const int64_t w[3],
+                     int px0, int py0, int px1, int py1, float& written_min, float& written_max)
+    {
+        float varyings[ShadedVertex::MAX_VARYINGS];
+        int64_t row[3] = {w[0], w[1], w[2]};
+        size_t fragments = 0;
+        for(int y = py0; y <= py1; ++y)
+        {
+            int64_t e[3] = {row[0], row[1], row[2]};
+            float* depth_row = target->depth.data() + (size_t) y * target->width;
+            uint32_t* color_row = target->color.data() + (size_t) y * target->width;
+            for(int x = px0; x <= px1; ++x)
+            {
+                if(!TEST || edges.inside(e))
+                {
+                    float b0 = (float) e[1] * edges.inv_area;
+                    float b1 = (float) e[2] * edges.inv_area;
+                    float b2 = (float) e[0] * edges.inv_area;
+                    float z = b0 * t.z[0] + b1 * t.z[1] + b2 * t.z[2];
+                    if(!TEST || z < depth_row[x])
+                    {
+                        // 透视校正：varying / w 和 1 / w 在屏幕空间线性
+                        float inv = 1.0f / (b0 * t.inv_w[0] + b1 * t.inv_w[1] + b2 * t.inv_w[2]);
+                        for(int k = 0; k < varying_count; ++k)
+                            varyings[k] = (b0 * t.varyings[0][k] + b1 * t.varyings[1][k] + b2 * t.varyings[2][k]) * inv;
+                        depth_row[x] = z;
+                        color_row[x] = packColor(fragment_function(varyings));
+                        written_min = std::min(written_min, z);
+                        written_max = std::max(written_max, z);
+                        ++fragments;
+                    }
+                }
+                for(int i = 0; i < 3; ++i)
+                    e[i] += edges.step_x[i];
+            }
+            for(int i = 0; i < 3; ++i)
+                row[i] += edges.step_y[i];
+        }
+        return fragments;
+    }
+    // 块内部分像素被改写后重新统计深度范围，最多 64 个像素
+    void updateBlock(size_t block, int bx, int by, int block_x1, int block_y1)
+    {
+        float low = target->depth[(size_t) by * target->width + bx];
+        float high = low;
+        for(int y = by; y <= block_y1; ++y)
+        {
+            const float* depth_row = target->depth.data() + (size_t) y * target->width;
+            for(int x = bx; x <= block_x1; ++x)
+            {
+                low = std::min(low, depth_row[x]);
+                high = std::max(high, depth_row[x]);
+            }
+        }
+        target->block_min[block] = low;
+        target->block_max[block] = high;
+    }
+};
+
+#endif /* Pipeline_h */
@@ -0,0 +1,168 @@
+//
+//  Polygon.h
+//  CG
+//
+
+#ifndef Polygon_h
+#define Polygon_h
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "Rasterizer.h"
+
+enum FillRule {
+    FILL_EVEN_ODD,
+    FILL_NON_ZERO
+};
+
+// 有序边表 + 活性边表扫描转换，支持凹多边形和多轮廓（洞）。
+// 每条边覆盖 [y_min, y_max) 的扫描线，像素中心 x 落在交点区间 [x_left, x_right) 内才填充，
+// 相邻多边形共享的边不会被重复填充。代价与扫描线数 + 边数 + 输出跨度数成正比。
+class PolygonScanner {
+public:
+    typedef std::vector<std::pair<int, int>> Contour;
+
+    // 结果追加到 spans，按 y 递增、同一行内按 x 递增
+    void scan(const std::vector<Contour>& contours, FillRule rule, std::vector<Span>& spans)
+    {
+        buildEdgeTable(contours);
+        if(edges.empty())
+            return;
+        active.clear();
+        for(int y = y_min; y < y_max; ++y)
+        {
+            // 移除已经结束的边，其余边前进一行
+            size_t kept = 0;
+            for(size_t i = 0; i < active.size(); ++i)
+            {
+                Edge& edge = edges[active[i]];
+                if(edge.y_max <= y)
+                    continue;
+                edge.advance(y);
+                active[kept++] = active[i];
+            }
+            active.resize(kept);
+            for(int index = heads[y - y_min]; index >= 0; index = edges[index].next)
+            {
+                edges[index].advance(y);
+                active.push_back(index);
+            }
+            // 活性边几乎总是有序的，插入排序是线性的
+            for(size_t i = 1; i < active.size(); ++i)
+            {
+                int current = active[i];
+                size_t j = i;
+                for(; j > 0 && edges[active[j - 1]].x > edges[current].x; --j)
+                    active[j] = active[j - 1];
+                active[j] = current;
+            }
+            emitSpans(y, rule, spans);
+        }
+    }
+    std::vector<Span> scan(const std::vector<Contour>& contours, FillRule rule = FILL_EVEN_ODD)
+    {
+        std::vector<Span> spans;
+        scan(contours, rule, spans);
+        return spans;
+    }
+private:
+    struct Edge {
+        int y_min;
+        int y_max;
+        int x_start;
+        int delta_x;
+        int delta_y;
+        int winding;
+        int next;
+        double x;
+        // 每行直接由端点求交点，避免累加误差让恰好落在格点上的交点取整错误
+        void advance(int y)
+        {
+            x = x_start + (double) ((long long) (y - y_min) * delta_x) / delta_y;
+        }
+    };
+    std::vector<Edge> edges;
+    std::vector<int> heads;
+    std::vector<int> active;
+    int y_min;
+    int y_max;
+
+    void buildEdgeTable(const std::vector<Contour>& contours)
+    {
+        edges.clear();
+        y_min = 0;
+        y_max = 0;
+        for(const Contour& contour : contours)
+        {
+            size_t n = contour.size();
+            for(size_t i = 0; i < n && n >= 3; ++i)
+            {
+                std::pair<int, int> p = contour[i];
+                std::pair<int, int> q = contour[(i + 1) % n];
+                // 水平边不与任何扫描线相交
+                if(p.second == q.second)
+                    continue;
+                Edge edge;
+                edge.winding = 1;
+                if(p.second > q.second)
+                {
+                    std::swap(p, q);
+                    edge.winding = -1;
+                }
+                edge.y_min = p.second;
+                edge.y_max = q.second;
+                edge.x_start = p.first;
+                edge.delta_x = q.first - p.first;
+                edge.delta_y = q.second - p.second;
+                edge.x = p.first;
+                edge.next = -1;
+                if(edges.empty())
+                {
+                    y_min = edge.y_min;
+                    y_max = edge.y_max;
+                }
+                y_min = std::min(y_min, edge.y_min);
+                y_max = std::max(y_max, edge.y_max);
+                edges.push_back(edge);
+            }
+        }
+        heads.assign(y_max - y_min, -1);
+        // 倒序插入，同一桶内保持原来的边顺序
+        for(int i = (int) edges.size() - 1; i >= 0; --i)
+        {
+            int& head = heads[edges[i].y_min - y_min];
+            edges[i].next = head;
+            head = i;
+        }
+    }
+    void emitSpans(int y, FillRule rule, std::vector<Span>& spans)
+    {
+        int winding = 0;
+        double x_left = 0.0;
+        for(size_t i = 0; i < active.size(); ++i)
+        {
+            const Edge& edge = edges[active[i]];
+            bool was_inside = rule == FILL_EVEN_ODD ? (winding & 1) != 0 : winding != 0;
+            winding += rule == FILL_EVEN_ODD ? 1 : edge.winding;
+            bool inside = rule == FILL_EVEN_ODD ? (winding & 1) != 0 : winding != 0;
+            if(!was_inside && inside)
+                x_left = edge.x;
+            else if(was_inside && !inside)
+            {
+                int x0 = (int) std::ceil(x_left);
+                int x1 = (int) std::ceil(edge.x) - 1;
+                if(x0 > x1)
+                    continue;
+                // 与上一段相接则合并
+                if(!spans.empty() && spans.back().y == y && spans.back().x1 + 1 >= x0)
+                    spans.back().x1 = std::max(spans.back().x1, x1);
+                else
+                    spans.push_back(Span{y, x0, x1});
+            }
+        }
+    }
+};
+
+#endif /* Polygon_h */
@@ -0,0 +1,452 @@
+//
+//  Rasterizer.h
+//  CG
+//
+
+#ifndef Rasterizer_h
+#define Rasterizer_h
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Span.h"
+
+// 坐标与 HW3 一致：整数格点，(0, 0) 在屏幕中心，坐标绝对值需小于 16384
+struct Triangle {
+    int x1, y1;
+    int x2, y2;
+    int x3, y3;
+    uint32_t color;
+};
+
+// 由调用方持有的帧缓冲，坐标 (x, y) 对应 pixels[(y + origin_y) * width + x + origin_x]
+struct Framebuffer {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int origin_x;
+    int origin_y;
+};
+
+inline void fillSpans(const std::vector<Span>& spans, Framebuffer& fb, uint32_t color)
+{
+    for(const Span& span : spans)
+    {
+        int y = span.y + fb.origin_y;
+        if(y < 0 || y >= fb.height)
+            continue;
+        int x0 = std::max(span.x0 + fb.origin_x, 0);
+        int x1 = std::min(span.x1 + fb.origin_x, fb.width - 1);
+        if(x0 <= x1)
+            std::fill(fb.pixels + (size_t) y * fb.width + x0, fb.pixels + (size_t) y * fb.width + x1 + 1, color);
+    }
+}
+
+// 边函数 E(x, y) = a * x + b * y + c，三条边都 >= 0 的格点在三角形内（含边界）
+struct EdgeSetup {
+    int a[3];
+    int b[3];
+    int c[3];
+    int min_x, min_y, max_x, max_y;
+};
+
+inline bool setupTriangle(const Triangle& t, EdgeSetup& e)
+{
+    int x1 = t.x1, y1 = t.y1;
+    int x2 = t.x2, y2 = t.y2;
+    int x3 = t.x3, y3 = t.y3;
+    int area = (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1);
+    if(area == 0)
+        return false;
+    // 顺时针则交换两个顶点，统一为逆时针
+    if(area < 0)
+    {
+        std::swap(x2, x3);
+        std::swap(y2, y3);
+    }
+    const int xs[3] = {x1, x2, x3};
+    const int ys[3] = {y1, y2, y3};
+    for(int i = 0; i < 3; ++i)
+    {
+        int j = (i + 1) % 3;
+        e.a[i] = ys[i] - ys[j];
+        e.b[i] = xs[j] - xs[i];
+        e.c[i] = xs[i] * ys[j] - xs[j] * ys[i];
+    }
+    e.min_x = std::min(x1, std::min(x2, x3));
+    e.min_y = std::min(y1, std::min(y2, y3));
+    e.max_x = std::max(x1, std::max(x2, x3));
+    e.max_y = std::max(y1, std::max(y2, y3));
+    return true;
+}
+
+// 扫描 [x_start, x_end] 一行，w 为三条边在 x_start 处的值
+inline void fillRowScalar(uint32_t* row, int x_start, int x_end, const int w[3], const EdgeSetup& e, uint32_t color)
+{
+    int w0 = w[0], w1 = w[1], w2 = w[2];
+    for(int x = x_start; x <= x_end; ++x)
+    {
+        if((w0 | w1 | w2) >= 0)
+            row[x] = color;
+        w0 += e.a[0];
+        w1 += e.a[1];
+        w2 += e.a[2];
+    }
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RASTERIZER_X86_SIMD 1
+#include <immintrin.h>
+
+// 每次 4 个像素：三个边函数按位或后符号位为 0 即覆盖，用掩码混合写回
+__attribute__((target("sse2")))
+inline void fillRowSSE2(uint32_t* row, int x_start, int x_end, const int w[3], const EdgeSetup& e, uint32_t color)
+{
+    const __m128i minus_one = _mm_set1_epi32(-1);
+    const __m128i fill = _mm_set1_epi32((int) color);
+    // SSE2 没有 32 位乘法，初值直接按通道展开
+    __m128i w0 = _mm_setr_epi32(w[0], w[0] + e.a[0], w[0] + 2 * e.a[0], w[0] + 3 * e.a[0]);
+    __m128i w1 = _mm_setr_epi32(w[1], w[1] + e.a[1], w[1] + 2 * e.a[1], w[1] + 3 * e.a[1]);
+    __m128i w2 = _mm_setr_epi32(w[2], w[2] + e.a[2], w[2] + 2 * e.a[2], w[2] + 3 * e.a[2]);
+    const __m128i step0 = _mm_set1_epi32(4 * e.a[0]);
+    const __m128i step1 = _mm_set1_epi32(4 * e.a[1]);
+    const __m128i step2 = _mm_set1_epi32(4 * e.a[2]);
+    int x = x_start;
+    for(; x + 3 <= x_end; x += 4)
+    {
+        __m128i inside = _mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(w0, w1), w2), minus_one);
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(inside));
+        if(bits == 0xF)
+            _mm_storeu_si128((__m128i*) (row + x), fill);
+        else if(bits)
+        {
+            __m128i old = _mm_loadu_si128((const __m128i*) (row + x));
+            __m128i mixed = _mm_or_si128(_mm_and_si128(inside, fill), _mm_andnot_si128(inside, old));
+            _mm_storeu_si128((__m128i*) (row + x), mixed);
+        }
+        w0 = _mm_add_epi32(w0, step0);
+        w1 = _mm_add_epi32(w1, step1);
+        w2 = _mm_add_epi32(w2, step2);
+    }
+    if(x <= x_end)
+    {
+        int rest[3] = {_mm_cvtsi128_si32(w0), _mm_cvtsi128_si32(w1), _mm_cvtsi128_si32(w2)};
+        fillRowScalar(row, x, x_end, rest, e, color);
+    }
+}
+
+// 每次 8 个像素，尾部用通道掩码处理，不回退到标量
+__attribute__((target("avx2")))
+inline void fillRowAVX2(uint32_t* row, int x_start, int x_end, const int w[3], const EdgeSetup& e, uint32_t color)
+{
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    const __m256i fill = _mm256_set1_epi32((int) color);
+    __m256i w0 = _mm256_add_epi32(_mm256_set1_epi32(w[0]), _mm256_mullo_epi32(lane, _mm256_set1_epi32(e.a[0])));
+    __m256i w1 = _mm256_add_epi32(_mm256_set1_epi32(w[1]), _mm256_mullo_epi32(lane, _mm256_set1_epi32(e.a[1])));
+    __m256i w2 = _mm256_add_epi32(_mm256_set1_epi32(w[2]), _mm256_mullo_epi32(lane, _mm256_set1_epi32(e.a[2])));
+    const __m256i step0 = _mm256_set1_epi32(8 * e.a[0]);
+    const __m256i step1 = _mm256_set1_epi32(8 * e.a[1]);
+    const __m256i step2 = _mm256_set1_epi32(8 * e.a[2]);
+    for(int x = x_start; x <= x_end; x += 8)
+    {
+        __m256i inside = _mm256_cmpgt_epi32(_mm256_or_si256(_mm256_or_si256(w0, w1), w2), minus_one);
+        int rest = x_end - x + 1;
+        if(rest < 8)
+            inside = _mm256_and_si256(inside, _mm256_cmpgt_epi32(_mm256_set1_epi32(rest), lane));
+        if(rest >= 8 && _mm256_movemask_ps(_mm256_castsi256_ps(inside)) == 0xFF)
+            _mm256_storeu_si256((__m256i*) (row + x), fill);
+        else
+            _mm256_maskstore_epi32((int*) (row + x), inside, fill);
+        w0 = _mm256_add_epi32(w0, step0);
+        w1 = _mm256_add_epi32(w1, step1);
+        w2 = _mm256_add_epi32(w2, step2);
+    }
+}
+#endif
+
+typedef void (*FillRowKernel)(uint32_t*, int, int, const int*, const EdgeSetup&, uint32_t);
+
+// 运行时按 CPU 选择内核，只检测一次
+inline FillRowKernel selectFillRow(const char** name = NULL)
+{
+    static FillRowKernel kernel = NULL;
+    static const char* kernel_name = "scalar";
+    if(!kernel)
+    {
+        kernel = fillRowScalar;
+#ifdef RASTERIZER_X86_SIMD
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+        {
+            kernel = fillRowAVX2;
+            kernel_name = "avx2";
+        }
+        else if(__builtin_cpu_supports("sse2"))
+        {
+            kernel = fillRowSSE2;
+            kernel_name = "sse2";
+        }
+#endif
+    }
+    if(name)
+        *name = kernel_name;
+    return kernel;
+}
+
+inline void fillRow(uint32_t* row, int x_start, int x_end, const int w[3], const EdgeSetup& e, uint32_t color)
+{
+    static const FillRowKernel kernel = selectFillRow();
+    kernel(row, x_start, x_end, w, e, color);
+}
+
+// 在帧缓冲的 [x0, x1] x [y0, y1] 矩形（帧缓冲像素坐标）内光栅化一个三角形，
+// 每行用指定的内核填充，用于逐个内核比对结果
+inline void rasterizeTriangle(const EdgeSetup& e, uint32_t color, Framebuffer& fb,
+                              int x0, int y0, int x1, int y1, FillRowKernel kernel)
+{
+    int x_start = std::max(x0, e.min_x + fb.origin_x);
+    int x_end = std::min(x1, e.max_x + fb.origin_x);
+    int y_start = std::max(y0, e.min_y + fb.origin_y);
+    int y_end = std::min(y1, e.max_y + fb.origin_y);
+    if(x_start > x_end || y_start > y_end)
+        return;
+    int px = x_start - fb.origin_x;
+    int py = y_start - fb.origin_y;
+    int w[3];
+    for(int i = 0; i < 3; ++i)
+        w[i] = e.a[i] * px + e.b[i] * py + e.c[i];
+    for(int y = y_start; y <= y_end; ++y)
+    {
+        kernel(fb.pixels + (size_t) y * fb.width, x_start, x_end, w, e, color);
+        for(int i = 0; i < 3; ++i)
+            w[i] += e.b[i];
+    }
+}
+// 使用运行时选出的内核
+inline void rasterizeTriangle(const EdgeSetup& e, uint32_t color, Framebuffer& fb,
+                              int x0, int y0, int x1, int y1)
+{
+    static const FillRowKernel kernel = selectFillRow();
+    rasterizeTriangle(e, color, fb, x0, y0, x1, y1, kernel);
+}
+
+// 整数除法向下取整 / 向上取整（除数为正）
+inline int floorDiv(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+inline int ceilDiv(int a, int b)
+{
+    return -floorDiv(-a, b);
+}
+
+// 三角形按行输出跨度，与 rasterizeTriangle 覆盖的像素完全相同。
+// 每行由三条边函数直接解出 x 的区间，代价只与行数成正比
+inline void triangleSpans(const Triangle& t, std::vector<Span>& spans)
+{
+    EdgeSetup e;
+    if(!setupTriangle(t, e))
+        return;
+    for(int y = e.min_y; y <= e.max_y; ++y)
+    {
+        int x0 = e.min_x;
+        int x1 = e.max_x;
+        for(int i = 0; i < 3 && x0 <= x1; ++i)
+        {
+            // a * x + (b * y + c) >= 0
+            int rest = e.b[i] * y + e.c[i];
+            if(e.a[i] > 0)
+                x0 = std::max(x0, ceilDiv(-rest, e.a[i]));
+            else if(e.a[i] < 0)
+                x1 = std::min(x1, floorDiv(rest, -e.a[i]));
+            else if(rest < 0)
+                x1 = x0 - 1;
+        }
+        if(x0 <= x1)
+            spans.push_back(Span{y, x0, x1});
+    }
+}
+
+// 常驻的工作线程池。run 让调用线程和所有工作线程各执行一次 job，全部返回后 run 才返回，
+// job 内部自己用原子计数领取工作
+class WorkerPool {
+public:
+    WorkerPool(unsigned threads = std::thread::hardware_concurrency()):
+        generation(0),
+        busy(0),
+        quit(false),
+        job(NULL)
+    {
+        // 调用线程也参与工作，所以额外只需 threads - 1 个
+        for(unsigned i = 1; i < threads; ++i)
+            workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for(auto& worker : workers)
+            worker.join();
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void run(const std::function<void()>& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &task;
+            busy = (int) workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        task();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        job = NULL;
+    }
+    unsigned threadCount() const
+    {
+        return (unsigned) workers.size() + 1;
+    }
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned long generation;
+    int busy;
+    bool quit;
+    const std::function<void()>* job;
+
+    void workerLoop()
+    {
+        unsigned long seen = 0;
+        while(true)
+        {
+            const std::function<void()>* task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen] { return quit || generation != seen; });
+                if(quit)
+                    return;
+                seen = generation;
+                task = job;
+            }
+            (*task)();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --busy;
+            }
+            done.notify_one();
+        }
+    }
+};
+
+// 分块光栅化：屏幕按 TILE_SIZE 划分，三角形先按包围盒分到各块，
+// 每个块只由一个工作线程处理，因此写帧缓冲不需要加锁，块内按提交顺序绘制
+class TileRasterizer {
+public:
+    static const int TILE_SIZE = 64;
+
+    TileRasterizer(unsigned threads = std::thread::hardware_concurrency()):
+        pool(threads),
+        triangles(NULL),
+        fb(NULL),
+        tiles_x(0),
+        tiles_y(0)
+    {
+    }
+    TileRasterizer(const TileRasterizer&) = delete;
+    TileRasterizer& operator=(const TileRasterizer&) = delete;
+
+    void drawTriangles(const std::vector<Triangle>& batch, Framebuffer& target)
+    {
+        drawTriangles(batch.data(), batch.size(), target);
+    }
+    void drawTriangles(const Triangle* batch, size_t count, Framebuffer& target)
+    {
+        if(count == 0 || target.width <= 0 || target.height <= 0)
+            return;
+        triangles = batch;
+        fb = &target;
+        binTriangles(count);
+        next_tile.store(0);
+        pool.run([this] { processTiles(); });
+    }
+    // 最近一批中被分到块里的三角形实例数，用于估计分块开销
+    size_t binnedCount() const
+    {
+        size_t total = 0;
+        for(auto& bin : bins)
+            total += bin.size();
+        return total;
+    }
+    unsigned threadCount() const
+    {
+        return pool.threadCount();
+    }
+private:
+    WorkerPool pool;
+    std::atomic<int> next_tile;
+
+    const Triangle* triangles;
+    Framebuffer* fb;
+    int tiles_x;
+    int tiles_y;
+    std::vector<EdgeSetup> setups;
+    // bins 在批次之间复用，稳定后不再分配内存
+    std::vector<std::vector<uint32_t>> bins;
+
+    void binTriangles(size_t count)
+    {
+        tiles_x = (fb->width + TILE_SIZE - 1) / TILE_SIZE;
+        tiles_y = (fb->height + TILE_SIZE - 1) / TILE_SIZE;
+        if(bins.size() < (size_t) (tiles_x * tiles_y))
+            bins.resize(tiles_x * tiles_y);
+        for(auto& bin : bins)
+            bin.clear();
+        setups.resize(count);
+        for(size_t i = 0; i < count; ++i)
+        {
+            EdgeSetup& e = setups[i];
+            if(!setupTriangle(triangles[i], e))
+                continue;
+            int x0 = std::max(e.min_x + fb->origin_x, 0);
+            int y0 = std::max(e.min_y + fb->origin_y, 0);
+            int x1 = std::min(e.max_x + fb->origin_x, fb->width - 1);
+            int y1 = std::min(e.max_y + fb->origin_y, fb->height - 1);
+            if(x0 > x1 || y0 > y1)
+                continue;
+            for(int ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ++ty)
+                for(int tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; ++tx)
+                    bins[ty * tiles_x + tx].push_back((uint32_t) i);
+        }
+    }
+    void processTiles()
+    {
+        int tile_count = tiles_x * tiles_y;
+        for(int tile = next_tile++; tile < tile_count; tile = next_tile++)
+        {
+            int x0 = (tile % tiles_x) * TILE_SIZE;
+            int y0 = (tile / tiles_x) * TILE_SIZE;
+            int x1 = std::min(x0 + TILE_SIZE, fb->width) - 1;
+            int y1 = std::min(y0 + TILE_SIZE, fb->height) - 1;
+            for(uint32_t index : bins[tile])
+                rasterizeTriangle(setups[index], triangles[index].color, *fb, x0, y0, x1, y1);
+        }
+    }
+};
+
+#endif /* Rasterizer_h */
@@ -0,0 +1,90 @@
+//
+//  Scanline.h
+//  CG
+//
+
+#ifndef Scanline_h
+#define Scanline_h
+
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Bonus1 原来的三角形填充：三条边的 Bresenham 像素以 (y, x) 放进优先队列，
+// 再逐行取出每行最左、最右两个点之间的像素。
+// 只保留作为 Benchmark 中与跨度光栅化对比的基准
+
+// 线段像素以 (y, x) 加入优先队列
+inline void bresenhamLine(std::priority_queue<std::pair<int, int>>& coordinates_xy,
+                         int x_start, int y_start, int x_end, int y_end)
+{
+    int sign = 1;
+    int delta_x = x_end - x_start;
+    if(delta_x < 0)
+    {
+        delta_x *= -1;
+        std::swap(x_start, x_end);
+        std::swap(y_start, y_end);
+    }
+    int delta_y = y_end - y_start;
+    // 斜率为负，作y轴轴对称
+    if(delta_y < 0)
+    {
+        delta_y *= -1;
+        sign = -1;
+        std::swap(x_start, x_end);
+        std::swap(y_start, y_end);
+        x_start *= -1;
+        x_end *= -1;
+    }
+    bool rotate = false;
+    // 斜率大于1，x y交换
+    if(delta_y > delta_x)
+    {
+        std::swap(x_start, y_start);
+        std::swap(x_end, y_end);
+        std::swap(delta_x, delta_y);
+        rotate = true;
+    }
+    int p_i = 2 * delta_y - delta_x;
+    int y_last = y_start;
+    for(int i = 0; i < delta_x; ++i)
+    {
+        if(p_i <= 0)
+        p_i += 2 * delta_y;
+        else
+        {
+            ++y_last;
+            p_i += 2 * delta_y - 2 * delta_x;
+        }
+        coordinates_xy.push(std::pair<int, int>(
+            rotate ? x_start + i : y_last,
+            rotate ? sign * y_last : sign * (x_start + i)));
+    }
+}
+
+inline std::vector<std::pair<int, int>> rasterization(std::priority_queue<std::pair<int, int>> coordinates_xy)
+{
+    std::vector<std::pair<int, int>> rasterized_coordinates_xy;
+    while(!coordinates_xy.empty())
+    {
+        std::pair<int, int> end = coordinates_xy.top();
+        std::pair<int, int> start = end;
+        coordinates_xy.pop();
+        if(!coordinates_xy.empty())
+        {
+            start = coordinates_xy.top();
+            if(start.first != end.first)
+                start = end;
+            else
+                coordinates_xy.pop();
+        }
+        rasterized_coordinates_xy.push_back(std::pair<int, int>(start.second, start.first));
+        rasterized_coordinates_xy.push_back(std::pair<int, int>(end.second, start.first));
+        for(int x = start.second; x <= end.second; ++x)
+            rasterized_coordinates_xy.push_back(std::pair<int, int>(x, start.first));
+    }
+    return rasterized_coordinates_xy;
+}
+
+#endif /* Scanline_h */
@@ -0,0 +1,62 @@
+//
+//  Span.h
+//  CG
+//
+
+#ifndef Span_h
+#define Span_h
+
+#include <vector>
+
+// 水平跨度：第 y 行的 [x0, x1]，两端都包含
+struct Span {
+    int y;
+    int x0;
+    int x1;
+};
+
+// 追加一个像素，与上一段同行且相邻时并入上一段
+inline void appendPixel(std::vector<Span>& spans, int x, int y)
+{
+    if(!spans.empty())
+    {
+        Span& last = spans.back();
+        if(last.y == y && x >= last.x0 - 1 && x <= last.x1 + 1)
+        {
+            if(x < last.x0)
+                last.x0 = x;
+            if(x > last.x1)
+                last.x1 = x;
+            return;
+        }
+    }
+    spans.push_back(Span{y, x, x});
+}
+
+// 每个跨度转为一条 GL_LINES 线段的两个端点，终点延长一格使单像素跨度也有长度
+inline void spansToLines(const std::vector<Span>& spans, std::vector<int>& coordinates_xy)
+{
+    size_t offset = coordinates_xy.size();
+    coordinates_xy.resize(offset + 4 * spans.size());
+    int* out = coordinates_xy.data() + offset;
+    for(const Span& span : spans)
+    {
+        *out++ = span.x0;
+        *out++ = span.y;
+        *out++ = span.x1 + 1;
+        *out++ = span.y;
+    }
+}
+
+// 调试用：展开为逐像素坐标
+inline void spansToPixels(const std::vector<Span>& spans, std::vector<int>& coordinates_xy)
+{
+    for(const Span& span : spans)
+        for(int x = span.x0; x <= span.x1; ++x)
+        {
+            coordinates_xy.push_back(x);
+            coordinates_xy.push_back(span.y);
+        }
+}
+
+#endif /* Span_h */
@@ -0,0 +1,178 @@
+//
+//  StreamBuffer.h
+//  CG
+//
+
+#ifndef StreamBuffer_h
+#define StreamBuffer_h
+
+#include <glad/glad.h>
+#include <cmath>
+#include <cstdint>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Span.h"
+
+// 三缓冲的流式顶点缓冲。顶点为两个 GL_SHORT 归一化分量（4 字节，原来是 3 个 float 共 12 字节）。
+// 归一化后的范围是 [-1, 1]，对应 NDC 的 [-RANGE, RANGE]，屏幕外一些的点不会被压到边上，
+// 顶点着色器需要乘回 RANGE，见 vertexShaderSource。
+// 每帧写入环上的下一段，用 glMapBufferRange 不同步映射直接写，
+// 通过 fence 保证 GPU 读完这一段之后才会被再次覆盖，缓冲本身不重新分配。
+// OpenGL 3.3 / macOS 4.1 没有持久映射（GL_MAP_PERSISTENT_BIT 需要 4.4），所以每段写完即解除映射
+class StreamBuffer {
+public:
+    static const int SEGMENTS = 3;
+    static constexpr float RANGE = 2.0f;
+
+    // 配套的顶点着色器，乘回的比例由 RANGE 生成，与 pack 的缩放始终一致
+    static std::string vertexShaderSource()
+    {
+        std::ostringstream source;
+        source.imbue(std::locale::classic());
+        source << std::showpoint
+               << "#version 330 core\n"
+                  "layout (location = 0) in vec2 aPos;\n"
+                  "void main()\n"
+                  "{\n"
+                  "   gl_Position = vec4(aPos * " << RANGE << ", 0.0, 1.0);\n"
+                  "}\n";
+        return source.str();
+    }
+
+    StreamBuffer(size_t vertices_per_segment = 1 << 16):
+        capacity(vertices_per_segment),
+        current(0),
+        first(0),
+        count(0),
+        mapped(NULL)
+    {
+        for(int i = 0; i < SEGMENTS; ++i)
+            fences[i] = 0;
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        allocate();
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_TRUE, 2 * sizeof(int16_t), (void*)0);
+        glEnableVertexAttribArray(0); // pos
+        glBindBuffer(GL_ARRAY_BUFFER, 0); // unbind VBO
+        glBindVertexArray(0); // unbind VAO
+    }
+    ~StreamBuffer()
+    {
+        for(int i = 0; i < SEGMENTS; ++i)
+            if(fences[i])
+                glDeleteSync(fences[i]);
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+    }
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // 映射下一段并返回可写入 vertices 个顶点的指针，写完后调用 unmap
+    int16_t* map(size_t vertices)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if(vertices > capacity)
+        {
+            // 超出容量时整体扩大一次，旧数据不再需要
+            while(capacity < vertices)
+                capacity *= 2;
+            allocate();
+            current = 0;
+        }
+        else
+            current = (current + 1) % SEGMENTS;
+        waitSegment(current);
+        first = (GLint) (current * capacity);
+        count = (GLsizei) vertices;
+        if(vertices == 0)
+            return NULL;
+        GLintptr offset = current * capacity * 2 * sizeof(int16_t);
+        mapped = (int16_t*) glMapBufferRange(GL_ARRAY_BUFFER, offset, vertices * 2 * sizeof(int16_t),
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        return mapped;
+    }
+    void unmap()
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if(mapped)
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        mapped = NULL;
+    }
+    // 上传 (x, y) 交替排列的像素坐标，坐标与 normalize 一致地除以 width / height
+    void upload(const std::vector<int>& coordinates_xy, unsigned width, unsigned height)
+    {
+        size_t vertices = coordinates_xy.size() / 2;
+        int16_t* out = map(vertices);
+        if(out)
+            for(size_t i = 0; i < vertices; ++i)
+            {
+                *out++ = pack(coordinates_xy[2 * i], width);
+                *out++ = pack(coordinates_xy[2 * i + 1], height);
+            }
+        unmap();
+    }
+    // 跨度直接写成 GL_LINES 端点，与 spansToLines 相同但不经过中间数组
+    void uploadSpans(const std::vector<Span>& spans, unsigned width, unsigned height)
+    {
+        int16_t* out = map(2 * spans.size());
+        if(out)
+            for(const Span& span : spans)
+            {
+                int16_t y = pack(span.y, height);
+                *out++ = pack(span.x0, width);
+                *out++ = y;
+                *out++ = pack(span.x1 + 1, width);
+                *out++ = y;
+            }
+        unmap();
+    }
+    // 画出最近一次上传的内容，并在这一段上插入 fence
+    void draw(GLenum mode)
+    {
+        glBindVertexArray(VAO);
+        glDrawArrays(mode, first, count);
+        if(fences[current])
+            glDeleteSync(fences[current]);
+        fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    GLsizei vertexCount() const
+    {
+        return count;
+    }
+    static int16_t pack(int coordinate, unsigned extent)
+    {
+        float value = (float) coordinate / extent / RANGE;
+        value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+        return (int16_t) std::lround(value * 32767.0f);
+    }
+private:
+    uint VAO, VBO;
+    size_t capacity;
+    int current;
+    GLint first;
+    GLsizei count;
+    int16_t* mapped;
+    GLsync fences[SEGMENTS];
+
+    void allocate()
+    {
+        for(int i = 0; i < SEGMENTS; ++i)
+            waitSegment(i);
+        glBufferData(GL_ARRAY_BUFFER, SEGMENTS * capacity * 2 * sizeof(int16_t), NULL, GL_STREAM_DRAW);
+    }
+    void waitSegment(int segment)
+    {
+        if(!fences[segment])
+            return;
+        while(glClientWaitSync(fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fences[segment]);
+        fences[segment] = 0;
+    }
+};
+
+#endif /* StreamBuffer_h */
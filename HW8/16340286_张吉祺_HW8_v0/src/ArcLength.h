@@ -0,0 +1,157 @@
+//
+//  ArcLength.h
+//  CG
+//
+
+#ifndef ArcLength_h
+#define ArcLength_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Bezier.h"
+
+// Bézier 曲线的弧长表，用于沿曲线匀速运动（动画、相机轨道）。
+// 把 [0, 1] 分为若干 t 区间，每个区间用 5 点 Gauss–Legendre 积分 |B'(t)|，得到累积弧长；
+// 查询时二分找到区间，区间内用两端的 dt/ds = 1 / |B'(t)| 做三次 Hermite 插值，不需要每帧解方程。
+// 区间按速度变化自适应二分，直到插值和积分的误差都低于全长的 TOLERANCE。
+// 控制点改变后调用 invalidate()，下一次 update() 时重建
+class ArcLength {
+public:
+    ArcLength():
+        valid(false)
+    {
+    }
+
+    void invalidate()
+    {
+        valid = false;
+    }
+
+    // 表已失效时按 nodes 重建
+    void update(const std::vector<Point>& nodes)
+    {
+        if (valid)
+            return;
+        valid = true;
+        int n = (int) nodes.size() - 1;
+        params.assign(1, 0.0);
+        lengths.assign(1, 0.0);
+        speeds.clear();
+        if (n < 1)
+        {
+            speeds.push_back(0.0);
+            return;
+        }
+        // 导矢是以 n (P_{i + 1} - P_i) 为控制点的 n - 1 次曲线
+        derivative.resize(n);
+        for (int i = 0; i < n; ++i)
+            derivative[i] = Point(n * (nodes[i + 1].first - nodes[i].first), n * (nodes[i + 1].second - nodes[i].second));
+        // 先用 max(8n, 32) 个等长区间估计全长，作为误差的尺度
+        int intervals = std::max(8 * n, 32);
+        double h = 1.0 / intervals;
+        double total = 0.0;
+        for (int k = 0; k < intervals; ++k)
+            total += integrate(k * h, (k + 1) * h);
+        tolerance = TOLERANCE * total;
+        speeds.push_back(speed(0.0));
+        for (int k = 0; k < intervals; ++k)
+            refine(k * h, (k + 1) * h, integrate(k * h, (k + 1) * h));
+    }
+
+    double length() const
+    {
+        return lengths.back();
+    }
+
+    // 弧长为 s 处的参数 t，s 超出 [0, length()] 时取端点。O(log 区间数)
+    double parameterAt(double s) const
+    {
+        int intervals = (int) lengths.size() - 1;
+        if (intervals <= 0 || s <= 0.0)
+            return 0.0;
+        if (s >= lengths.back())
+            return 1.0;
+        int k = (int) (std::upper_bound(lengths.begin(), lengths.end(), s) - lengths.begin()) - 1;
+        double ds = lengths[k + 1] - lengths[k];
+        if (ds <= 0.0)
+            return params[k];
+        return hermite(params[k], params[k + 1], speeds[k], speeds[k + 1], ds, (s - lengths[k]) / ds);
+    }
+private:
+    // 相对全长的目标误差
+    static constexpr double TOLERANCE = 1e-6;
+    // 区间总数和最小区间长度的上限，尖点附近 dt/ds 无界，靠它们停止二分
+    static const int MAX_INTERVALS = 4096;
+    static constexpr double MIN_WIDTH = 1.0 / (1 << 20);
+
+    bool valid;
+    double tolerance;
+    std::vector<Point> derivative;
+    std::vector<double> params;  // 各区间端点的 t
+    std::vector<double> lengths; // lengths[k] 为 t = params[k] 处的累积弧长
+    std::vector<double> speeds;  // speeds[k] 为同一处的 |B'(t)|
+
+    double speed(double t) const
+    {
+        Point d = bezierPoint(derivative, t);
+        return std::sqrt(d.first * d.first + d.second * d.second);
+    }
+
+    // [a, b] 上 |B'(t)| 的 5 点 Gauss–Legendre 积分
+    double integrate(double a, double b) const
+    {
+        // 节点与权重（区间 [-1, 1]）
+        static const double abscissas[5] = {
+            0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640
+        };
+        static const double gauss_weights[5] = {
+            0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891
+        };
+        double middle = 0.5 * (a + b), half = 0.5 * (b - a);
+        double sum = 0.0;
+        for (int i = 0; i < 5; ++i)
+            sum += gauss_weights[i] * speed(middle + half * abscissas[i]);
+        return half * sum;
+    }
+
+    // 区间 [t0, t1] 内弧长比例为 u 处的 t；速度为 0（尖点）的一端退化为线性插值
+    static double hermite(double t0, double t1, double v0, double v1, double ds, double u)
+    {
+        double h = t1 - t0;
+        double m0 = v0 > 0.0 ? ds / v0 : h;
+        double m1 = v1 > 0.0 ? ds / v1 : h;
+        double u2 = u * u, u3 = u2 * u;
+        double t = (2 * u3 - 3 * u2 + 1) * t0 + (u3 - 2 * u2 + u) * m0
+                 + (-2 * u3 + 3 * u2) * t1 + (u3 - u2) * m1;
+        return std::min(std::max(t, t0), t1);
+    }
+
+    // 把 [a, b]（弧长 ds）加入表中，插值或积分不够准时对半分开后分别加入。
+    // 按顺序递归，表中的区间保持从小到大
+    void refine(double a, double b, double ds)
+    {
+        double middle = 0.5 * (a + b);
+        double left = integrate(a, middle), right = integrate(middle, b);
+        double v0 = speeds.back(), v1 = speed(b);
+        bool split = std::fabs(left + right - ds) > tolerance;
+        // 在 u = 1/4, 1/2, 3/4 处比较插值得到的 t 与其真实弧长
+        for (int i = 1; i <= 3 && !split; ++i)
+        {
+            double u = 0.25 * i;
+            double t = hermite(a, b, v0, v1, ds, u);
+            split = std::fabs(integrate(a, t) - u * ds) > tolerance;
+        }
+        if (split && b - a > MIN_WIDTH && (int) lengths.size() < MAX_INTERVALS)
+        {
+            refine(a, middle, left);
+            refine(middle, b, right);
+            return;
+        }
+        params.push_back(b);
+        lengths.push_back(lengths.back() + (split ? left + right : ds));
+        speeds.push_back(v1);
+    }
+};
+
+#endif /* ArcLength_h */
@@ -0,0 +1,177 @@
+//
+//  BSpline.h
+//  CG
+//
+
+#ifndef BSpline_h
+#define BSpline_h
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "Bezier.h"
+
+// 均匀三次 B 样条，第 i 段只由控制点 P_i .. P_{i + 3} 决定，m 个控制点共 m - 3 段。
+// 每段取 SAMPLES + 1 个点，相邻段共用端点，第 i 段在 points 中占 [i * SAMPLES, (i + 1) * SAMPLES]。
+// 插入、删除、移动一个控制点只重新计算受影响的至多 4 段，
+// points 中变化的区间记录在 dirtyFirst() / dirtyLast() 中，供只更新 GPU buffer 的这一段
+class UniformBSpline {
+public:
+    static const int SAMPLES = 32;
+
+    UniformBSpline():
+        dirty_first(0),
+        dirty_last(0)
+    {
+    }
+
+    const std::vector<Point>& nodes() const
+    {
+        return control;
+    }
+    // 曲线折线的顶点，控制点少于 4 个时为空
+    const std::vector<Point>& points() const
+    {
+        return samples;
+    }
+
+    void insert(int index, const Point& p)
+    {
+        int old_segments = segmentCount();
+        control.insert(control.begin() + index, p);
+        if (old_segments <= 0)
+        {
+            rebuild();
+            return;
+        }
+        // 新的第 first .. index 段受影响，其后的段内容不变，只是整体后移一段
+        int first = std::max(index - 3, 0);
+        int last = std::min(index, segmentCount() - 1);
+        samples.insert(samples.begin() + (size_t) first * SAMPLES, SAMPLES, Point(0.0, 0.0));
+        for (int i = first; i <= last; ++i)
+            evaluateSegment(i);
+        markDirty((size_t) first * SAMPLES, samples.size());
+    }
+    void push_back(const Point& p)
+    {
+        insert((int) control.size(), p);
+    }
+
+    void erase(int index)
+    {
+        control.erase(control.begin() + index);
+        int segments = segmentCount();
+        if (segments <= 0)
+        {
+            rebuild();
+            return;
+        }
+        // 原来的第 index + 1 段之后整体前移一段，新的第 first .. index - 1 段重新计算。
+        // first > 0 时第 first - 1 段不变，保留它的终点，去掉原第 first 段的其余 SAMPLES 个点
+        int first = std::max(index - 3, 0);
+        int last = std::min(index - 1, segments - 1);
+        size_t offset = (size_t) first * SAMPLES + (first > 0 ? 1 : 0);
+        samples.erase(samples.begin() + offset, samples.begin() + offset + SAMPLES);
+        for (int i = first; i <= last; ++i)
+            evaluateSegment(i);
+        markDirty((size_t) first * SAMPLES, samples.size());
+    }
+    void pop_back()
+    {
+        if (!control.empty())
+            erase((int) control.size() - 1);
+    }
+
+    void move(int index, const Point& p)
+    {
+        control[index] = p;
+        int segments = segmentCount();
+        if (segments <= 0)
+            return;
+        int first = std::max(index - 3, 0);
+        int last = std::min(index, segments - 1);
+        for (int i = first; i <= last; ++i)
+            evaluateSegment(i);
+        markDirty((size_t) first * SAMPLES, (size_t) (last + 1) * SAMPLES + 1);
+    }
+
+    // 上次 clearDirty 以来 points 中需要重新上传的区间 [dirtyFirst, dirtyLast)
+    size_t dirtyFirst() const
+    {
+        return dirty_first;
+    }
+    size_t dirtyLast() const
+    {
+        return dirty_last;
+    }
+    void clearDirty()
+    {
+        dirty_first = dirty_last = 0;
+    }
+private:
+    std::vector<Point> control;
+    std::vector<Point> samples;
+    size_t dirty_first, dirty_last;
+
+    int segmentCount() const
+    {
+        return (int) control.size() - 3;
+    }
+
+    // 每个采样点上 4 个基函数的值，只算一次
+    static const double* basis()
+    {
+        static std::vector<double> weights;
+        if (weights.empty())
+        {
+            weights.resize(4 * (SAMPLES + 1));
+            for (int j = 0; j <= SAMPLES; ++j)
+            {
+                double t = (double) j / SAMPLES;
+                double s = 1.0 - t;
+                weights[4 * j] = s * s * s / 6.0;
+                weights[4 * j + 1] = (3.0 * t * t * t - 6.0 * t * t + 4.0) / 6.0;
+                weights[4 * j + 2] = (-3.0 * t * t * t + 3.0 * t * t + 3.0 * t + 1.0) / 6.0;
+                weights[4 * j + 3] = t * t * t / 6.0;
+            }
+        }
+        return weights.data();
+    }
+
+    void evaluateSegment(int i)
+    {
+        const double* w = basis();
+        const Point* p = control.data() + i;
+        Point* out = samples.data() + (size_t) i * SAMPLES;
+        for (int j = 0; j <= SAMPLES; ++j, w += 4)
+            out[j] = Point(w[0] * p[0].first + w[1] * p[1].first + w[2] * p[2].first + w[3] * p[3].first,
+                           w[0] * p[0].second + w[1] * p[1].second + w[2] * p[2].second + w[3] * p[3].second);
+    }
+
+    void rebuild()
+    {
+        int segments = segmentCount();
+        samples.assign(segments > 0 ? (size_t) segments * SAMPLES + 1 : 0, Point(0.0, 0.0));
+        for (int i = 0; i < segments; ++i)
+            evaluateSegment(i);
+        markDirty(0, samples.size());
+    }
+
+    void markDirty(size_t first, size_t last)
+    {
+        if (dirty_first == dirty_last)
+        {
+            dirty_first = first;
+            dirty_last = last;
+        }
+        else
+        {
+            dirty_first = std::min(dirty_first, first);
+            dirty_last = std::max(dirty_last, last);
+        }
+        dirty_last = std::min(dirty_last, samples.size());
+        dirty_first = std::min(dirty_first, dirty_last);
+    }
+};
+
+#endif /* BSpline_h */
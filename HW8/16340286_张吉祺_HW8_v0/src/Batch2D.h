@@ -0,0 +1,302 @@
+//
+//  Batch2D.h
+//  CG
+//
+
+#ifndef Batch2D_h
+#define Batch2D_h
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// 代替 glBegin / glEnd 的二维批量绘制，只需要 core profile 3.3。
+// 点、线段、折线、填充多边形都在 CPU 上展开成带颜色的三角形，累积在一个数组里，
+// flush 时整体上传到一个流式 VBO，一次 glDrawArrays 画完。
+// 坐标为 NDC，点的大小和线宽以像素计（与 glPointSize / glLineWidth 相同），
+// 所以需要知道视口大小。只依赖 glad，可以像 WorkerPool.h 一样直接复制到 HW2 / HW3 使用
+const char* const batchVertexShaderSource = "#version 330 core\n"
+"layout (location = 0) in vec2 aPos;\n"
+"layout (location = 1) in vec4 aColor;\n"
+"out vec4 ourColor;\n"
+"void main()\n"
+"{\n"
+"   gl_Position = vec4(aPos, 0.0, 1.0);\n"
+"   ourColor = aColor;\n"
+"}\0";
+
+const char* const batchFragmentShaderSource = "#version 330 core\n"
+"in vec4 ourColor;\n"
+"out vec4 FragColor;\n"
+"void main()\n"
+"{\n"
+"   FragColor = ourColor;\n"
+"}\n\0";
+
+// 8 位 RGBA 颜色，分量取值与 glColor3f 相同为 [0, 1]
+struct BatchColor {
+    uint8_t r, g, b, a;
+
+    BatchColor(float r, float g, float b, float a = 1.0f):
+        r(channel(r)),
+        g(channel(g)),
+        b(channel(b)),
+        a(channel(a))
+    {
+    }
+    static uint8_t channel(float v)
+    {
+        return (uint8_t) std::lround(std::min(std::max(v, 0.0f), 1.0f) * 255.0f);
+    }
+};
+
+class Batch2D {
+public:
+    // 折线拐角处斜接长度与线宽之比的上限，超过时截短，避免很尖的拐角伸出很长的尖刺
+    static constexpr float MITER_LIMIT = 4.0f;
+
+    Batch2D(uint width, uint height):
+        width(width),
+        height(height),
+        capacity(0),
+        drawCalls(0)
+    {
+        shaderProgram = compile();
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(0); // pos
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1); // color
+        glBindBuffer(GL_ARRAY_BUFFER, 0); // unbind VBO
+        glBindVertexArray(0); // unbind VAO
+    }
+    ~Batch2D()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteProgram(shaderProgram);
+    }
+    Batch2D(const Batch2D&) = delete;
+    Batch2D& operator=(const Batch2D&) = delete;
+
+    // 视口大小改变（如窗口缩放）后调用，之后加入的图元按新的像素大小展开
+    void resize(uint width, uint height)
+    {
+        this->width = width;
+        this->height = height;
+    }
+
+    // 以 (x, y) 为中心、边长 size 像素的正方形，与 glPointSize 画出的点相同
+    void point(float x, float y, float size, const BatchColor& color)
+    {
+        float hx = size / width, hy = size / height;
+        quad(x - hx, y - hy, x + hx, y - hy, x + hx, y + hy, x - hx, y + hy, color, color);
+    }
+
+    void line(float x0, float y0, float x1, float y1, float thickness, const BatchColor& color)
+    {
+        beginPolyline();
+        polylineVertex(x0, y0, thickness, color);
+        polylineVertex(x1, y1, thickness, color);
+        endPolyline();
+    }
+
+    // 逐个给出折线的顶点，每个顶点有自己的线宽和颜色，沿线段线性过渡。
+    // 拐角处两侧的边用斜接连起来，相邻两段之间没有缝隙
+    void beginPolyline()
+    {
+        path.clear();
+    }
+    void polylineVertex(float x, float y, float thickness, const BatchColor& color)
+    {
+        // 与上一个顶点重合时没有方向，跳过
+        if (!path.empty() && path.back().x == x && path.back().y == y)
+            return;
+        path.push_back(PathVertex{x, y, thickness, color});
+    }
+    void endPolyline()
+    {
+        size_t n = path.size();
+        if (n < 2)
+            return;
+        // 在像素坐标下求每个顶点两侧的偏移，再换回 NDC
+        float sx = width / 2.0f, sy = height / 2.0f;
+        std::vector<float>& offsets = scratch;
+        offsets.resize(2 * n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            float nx0, ny0, nx1, ny1;
+            normal(path[i > 0 ? i - 1 : i], path[i > 0 ? i : i + 1], sx, sy, nx0, ny0);
+            normal(path[i + 1 < n ? i : i - 1], path[i + 1 < n ? i + 1 : i], sx, sy, nx1, ny1);
+            float mx = nx0 + nx1, my = ny0 + ny1;
+            float length = std::sqrt(mx * mx + my * my);
+            float scale = path[i].thickness / 2.0f;
+            if (length > 1e-6f)
+            {
+                // 斜接方向上的长度为 1 / cos(θ / 2)
+                mx /= length;
+                my /= length;
+                scale /= std::max(mx * nx1 + my * ny1, 1.0f / MITER_LIMIT);
+            }
+            else
+            {
+                mx = nx1;
+                my = ny1;
+            }
+            offsets[2 * i] = mx * scale / sx;
+            offsets[2 * i + 1] = my * scale / sy;
+        }
+        for (size_t i = 0; i + 1 < n; ++i)
+        {
+            const PathVertex& a = path[i];
+            const PathVertex& b = path[i + 1];
+            float ax = offsets[2 * i], ay = offsets[2 * i + 1];
+            float bx = offsets[2 * i + 2], by = offsets[2 * i + 3];
+            quad(a.x + ax, a.y + ay, b.x + bx, b.y + by, b.x - bx, b.y - by, a.x - ax, a.y - ay,
+                 a.color, b.color, b.color, a.color);
+        }
+        path.clear();
+    }
+
+    // 实心三角形，顶点颜色在内部插值
+    void triangle(float x0, float y0, const BatchColor& c0, float x1, float y1, const BatchColor& c1,
+                  float x2, float y2, const BatchColor& c2)
+    {
+        vertices.push_back(Vertex{x0, y0, c0});
+        vertices.push_back(Vertex{x1, y1, c1});
+        vertices.push_back(Vertex{x2, y2, c2});
+    }
+    // 实心凸多边形，按扇形分成三角形
+    void beginPolygon()
+    {
+        path.clear();
+    }
+    void polygonVertex(float x, float y, const BatchColor& color)
+    {
+        path.push_back(PathVertex{x, y, 0.0f, color});
+    }
+    void endPolygon()
+    {
+        for (size_t i = 2; i < path.size(); ++i)
+            triangle(path[0].x, path[0].y, path[0].color, path[i - 1].x, path[i - 1].y, path[i - 1].color,
+                     path[i].x, path[i].y, path[i].color);
+        path.clear();
+    }
+
+    // 把累积的图元画出来并清空。与其他绘制交错时（例如先画网格再叠加 GPU 曲线），
+    // 在切换前 flush 一次以保持先后顺序，否则一帧只需要最后 flush 一次
+    void flush()
+    {
+        if (vertices.empty())
+            return;
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        size_t bytes = vertices.size() * sizeof(Vertex);
+        if (bytes > capacity)
+            capacity = std::max(capacity * 2, bytes);
+        // 每次重新指定存储（orphan），驱动可以另给一块内存，不必等 GPU 读完上一批
+        glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glUseProgram(shaderProgram);
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei) vertices.size());
+        glBindVertexArray(0);
+        glUseProgram(0);
+        ++drawCalls;
+        vertices.clear();
+    }
+
+    // 创建以来发出的 glDrawArrays 次数
+    unsigned long drawCallCount() const
+    {
+        return drawCalls;
+    }
+private:
+    struct Vertex {
+        float x, y;
+        BatchColor color;
+    };
+    struct PathVertex {
+        float x, y;
+        float thickness;
+        BatchColor color;
+    };
+
+    uint width, height;
+    std::vector<Vertex> vertices;
+    std::vector<PathVertex> path;
+    std::vector<float> scratch;
+    size_t capacity;
+    unsigned long drawCalls;
+    uint shaderProgram;
+    uint VAO, VBO;
+
+    // a 到 b 方向左侧的单位法向（像素坐标）
+    static void normal(const PathVertex& a, const PathVertex& b, float sx, float sy, float& nx, float& ny)
+    {
+        float dx = (b.x - a.x) * sx, dy = (b.y - a.y) * sy;
+        float length = std::sqrt(dx * dx + dy * dy);
+        nx = length > 0.0f ? -dy / length : 0.0f;
+        ny = length > 0.0f ? dx / length : 0.0f;
+    }
+
+    void quad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+              const BatchColor& c0, const BatchColor& c1)
+    {
+        quad(x0, y0, x1, y1, x2, y2, x3, y3, c0, c1, c1, c0);
+    }
+    void quad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+              const BatchColor& c0, const BatchColor& c1, const BatchColor& c2, const BatchColor& c3)
+    {
+        triangle(x0, y0, c0, x1, y1, c1, x2, y2, c2);
+        triangle(x0, y0, c0, x2, y2, c2, x3, y3, c3);
+    }
+
+    static uint compile()
+    {
+        int success;
+        char infoLog[512];
+        int vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShader, 1, &batchVertexShaderSource, NULL);
+        glCompileShader(vertexShader);
+        glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        }
+
+        int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragmentShader, 1, &batchFragmentShaderSource, NULL);
+        glCompileShader(fragmentShader);
+        glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        }
+
+        uint shaderProgram = glCreateProgram();
+        glAttachShader(shaderProgram, vertexShader);
+        glAttachShader(shaderProgram, fragmentShader);
+        glLinkProgram(shaderProgram);
+        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        }
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return shaderProgram;
+    }
+};
+
+#endif /* Batch2D_h */
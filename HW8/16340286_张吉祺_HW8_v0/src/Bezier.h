@@ -0,0 +1,226 @@
+//
+//  Bezier.h
+//  CG
+//
+
+#ifndef Bezier_h
+#define Bezier_h
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+typedef std::pair<double, double> Point;
+
+// 二项式系数表，按 Pascal 三角逐行递推，行在第一次用到时生成并缓存。
+// 系数用 double 保存，n 到 1000 左右都不会溢出（原来 int 阶乘在 13! 就溢出了）
+inline const std::vector<double>& binomials(int n)
+{
+    static std::vector<std::vector<double>> rows(1, std::vector<double>(1, 1.0));
+    while ((int) rows.size() <= n)
+    {
+        const std::vector<double>& last = rows.back();
+        std::vector<double> row(last.size() + 1, 1.0);
+        for (size_t k = 1; k < last.size(); ++k)
+            row[k] = last[k - 1] + last[k];
+        rows.push_back(row);
+    }
+    return rows[n];
+}
+
+// 求 B(t) = sum C(n, i) (1 - t)^(n - i) t^i P_i。
+// t <= 0.5 时提出 (1 - t)^n，对 u = t / (1 - t) 用 Horner 法；t > 0.5 时对称地提出 t^n。
+// u 不超过 1，每一步都是非负权重的累加，几百个控制点也不会有明显的舍入误差，且不需要 pow
+inline Point bezierPoint(const std::vector<Point>& nodes, double t)
+{
+    int n = (int) nodes.size() - 1;
+    if (n < 0)
+        return Point(0.0, 0.0);
+    const std::vector<double>& c = binomials(n);
+    bool reverse = t > 0.5;
+    double s = reverse ? t : 1.0 - t;
+    double u = reverse ? (1.0 - t) / t : t / (1.0 - t);
+    double x = 0.0, y = 0.0;
+    for (int k = n; k >= 0; --k)
+    {
+        const Point& p = nodes[reverse ? n - k : k];
+        x = x * u + c[k] * p.first;
+        y = y * u + c[k] * p.second;
+    }
+    // s^n 用二进制幂，避免 pow
+    double scale = 1.0;
+    for (int e = n; e > 0; e >>= 1, s *= s)
+        if (e & 1)
+            scale *= s;
+    return Point(x * scale, y * scale);
+}
+
+// 次数不超过该值时用前向差分，否则逐点 Horner。
+// 前向差分每个点只需 n 次加法，但误差随次数按 2^n 放大，只适合低次曲线
+const int FORWARD_DIFFERENCE_DEGREE = 3;
+
+// 在 t = 0, 1 / segments, ..., 1 处均匀取 segments + 1 个点，覆盖写入 points
+inline void sampleBezier(const std::vector<Point>& nodes, int segments, std::vector<Point>& points)
+{
+    points.clear();
+    int n = (int) nodes.size() - 1;
+    if (n < 0 || segments <= 0)
+        return;
+    points.reserve(segments + 1);
+    if (n > FORWARD_DIFFERENCE_DEGREE || segments < n)
+    {
+        for (int i = 0; i <= segments; ++i)
+            points.push_back(bezierPoint(nodes, (double) i / segments));
+        return;
+    }
+    // 前 n + 1 个点建立差分表 delta[k] = Δ^k B(0)，之后每步 delta[k] += delta[k + 1]
+    double dx[FORWARD_DIFFERENCE_DEGREE + 1], dy[FORWARD_DIFFERENCE_DEGREE + 1];
+    for (int k = 0; k <= n; ++k)
+    {
+        Point p = bezierPoint(nodes, (double) k / segments);
+        dx[k] = p.first;
+        dy[k] = p.second;
+    }
+    for (int order = 1; order <= n; ++order)
+        for (int k = n; k >= order; --k)
+        {
+            dx[k] -= dx[k - 1];
+            dy[k] -= dy[k - 1];
+        }
+    for (int i = 0; i < segments; ++i)
+    {
+        points.push_back(Point(dx[0], dy[0]));
+        for (int k = 0; k < n; ++k)
+        {
+            dx[k] += dx[k + 1];
+            dy[k] += dy[k + 1];
+        }
+    }
+    // 终点直接取最后一个控制点，不带累积误差
+    points.push_back(nodes.back());
+}
+
+// 自适应细分的最大深度，即最多 2^16 段
+const int MAX_SUBDIVISION_DEPTH = 16;
+
+// de Casteljau 在 t = 0.5 处把 n 次控制多边形 p 分为左右两半，左半写入 left，右半写入 right
+inline void splitBezier(const Point* p, int n, Point* left, Point* right)
+{
+    for (int i = 0; i <= n; ++i)
+        right[i] = p[i];
+    for (int level = 1; level <= n; ++level)
+    {
+        left[level - 1] = right[0];
+        for (int i = 0; i <= n - level; ++i)
+            right[i] = Point((right[i].first + right[i + 1].first) * 0.5, (right[i].second + right[i + 1].second) * 0.5);
+    }
+    left[n] = right[0];
+}
+
+// 控制多边形中间各点到首尾连线段的最大距离（像素）。曲线在控制点的凸包内，
+// 到线段的距离是凸函数，所以这是曲线偏离弦的上界；用线段而不是直线，折回的曲线也能被发现
+inline double bezierFlatness(const Point* p, int n, double scale_x, double scale_y)
+{
+    double x0 = p[0].first * scale_x, y0 = p[0].second * scale_y;
+    double dx = p[n].first * scale_x - x0, dy = p[n].second * scale_y - y0;
+    double length2 = dx * dx + dy * dy;
+    double flatness = 0.0;
+    for (int i = 1; i < n; ++i)
+    {
+        double px = p[i].first * scale_x - x0, py = p[i].second * scale_y - y0;
+        double t = length2 > 0.0 ? std::min(std::max((px * dx + py * dy) / length2, 0.0), 1.0) : 0.0;
+        double ex = px - t * dx, ey = py - t * dy;
+        flatness = std::max(flatness, ex * ex + ey * ey);
+    }
+    return std::sqrt(flatness);
+}
+
+inline void tessellateBezier(const Point* p, int n, int depth, double tolerance, double scale_x, double scale_y,
+                             Point* scratch, std::vector<Point>& points)
+{
+    if (depth >= MAX_SUBDIVISION_DEPTH || bezierFlatness(p, n, scale_x, scale_y) <= tolerance)
+    {
+        points.push_back(p[n]);
+        return;
+    }
+    // 每层在 scratch 中占用 2(n + 1) 个点，子问题使用之后的空间
+    Point* left = scratch;
+    Point* right = scratch + n + 1;
+    splitBezier(p, n, left, right);
+    tessellateBezier(left, n, depth + 1, tolerance, scale_x, scale_y, scratch + 2 * (n + 1), points);
+    tessellateBezier(right, n, depth + 1, tolerance, scale_x, scale_y, scratch + 2 * (n + 1), points);
+}
+
+// 按屏幕上的平直度自适应细分，输出折线顶点（含两端），覆盖写入 points。
+// 控制点为 NDC 坐标，scale_x / scale_y 为 NDC 到像素的比例（窗口宽高的一半），
+// tolerance 为折线与曲线之间允许的最大偏差（像素）。平直的曲线只输出两端，长而弯的曲线才细分得多
+inline void tessellateBezier(const std::vector<Point>& nodes, double tolerance, double scale_x, double scale_y,
+                             std::vector<Point>& points)
+{
+    points.clear();
+    int n = (int) nodes.size() - 1;
+    if (n < 0)
+        return;
+    points.push_back(nodes[0]);
+    if (n == 0)
+        return;
+    std::vector<Point> scratch(2 * (n + 1) * (MAX_SUBDIVISION_DEPTH + 1));
+    tessellateBezier(nodes.data(), n, 0, tolerance, scale_x, scale_y, scratch.data(), points);
+}
+
+// 迭代的 de Casteljau 求值，所有中间层保存在同一块三角形缓冲区中：
+// 第 k 层有 n + 1 - k 个点，第 0 层是控制点，第 n 层只有一个点即 B(t)。
+// 缓冲区只在控制点变多时扩大，之后每次求值不分配内存
+class DeCasteljau {
+public:
+    DeCasteljau():
+        n(-1)
+    {
+    }
+
+    void evaluate(const std::vector<Point>& nodes, double t)
+    {
+        n = (int) nodes.size() - 1;
+        if (n < 0)
+            return;
+        size_t size = (size_t) (n + 1) * (n + 2) / 2;
+        if (buffer.size() < size)
+            buffer.resize(size);
+        std::copy(nodes.begin(), nodes.end(), buffer.begin());
+        const Point* previous = buffer.data();
+        Point* current = buffer.data() + n + 1;
+        for (int k = 1; k <= n; ++k)
+        {
+            for (int i = 0; i <= n - k; ++i)
+                current[i] = Point((1 - t) * previous[i].first + t * previous[i + 1].first,
+                                   (1 - t) * previous[i].second + t * previous[i + 1].second);
+            previous = current;
+            current += n + 1 - k;
+        }
+    }
+
+    // 最近一次求值的次数，没有控制点时为 -1
+    int degree() const
+    {
+        return n;
+    }
+    // 第 k 层的首地址，共 levelSize(k) 个点
+    const Point* level(int k) const
+    {
+        return buffer.data() + (size_t) k * (n + 1) - (size_t) k * (k - 1) / 2;
+    }
+    int levelSize(int k) const
+    {
+        return n + 1 - k;
+    }
+    const Point& point() const
+    {
+        return *level(n);
+    }
+private:
+    int n;
+    std::vector<Point> buffer;
+};
+
+#endif /* Bezier_h */
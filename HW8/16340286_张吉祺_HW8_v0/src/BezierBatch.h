@@ -0,0 +1,182 @@
+//
+//  BezierBatch.h
+//  CG
+//
+
+#ifndef BezierBatch_h
+#define BezierBatch_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "Bezier.h"
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BEZIER_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// 一批同次数的曲线（字形轮廓、动画通道等）一起求值。
+// 控制点按 SoA 的 float 存放：x[i * stride + c] 是第 c 条曲线的第 i 个控制点，
+// 同一个 t 上各曲线的 Bernstein 权重相同，所以 8 条相邻曲线正好是一个 AVX 向量，
+// 每个采样点只需 n + 1 次向量乘加。与 HW3 的 Rasterizer.h 一样在运行时检测 CPU，
+// 支持 AVX2 和 FMA 时用 8 路内核，否则用标量循环，不需要特殊的编译选项
+class BezierBatch {
+public:
+    typedef void (BezierBatch::*Kernel)(int segments, float* out_x, float* out_y) const;
+    static const size_t BLOCK = 256;
+
+    BezierBatch(int degree, size_t count):
+        n(degree),
+        count(count),
+        padded((count + 7) / 8 * 8),
+        x((degree + 1) * padded, 0.0f),
+        y((degree + 1) * padded, 0.0f),
+        weight_segments(-1)
+    {
+    }
+
+    int degree() const
+    {
+        return n;
+    }
+    size_t size() const
+    {
+        return count;
+    }
+    // 输出中相邻采样点之间的间隔（曲线数补齐到 8 的倍数）
+    size_t stride() const
+    {
+        return padded;
+    }
+
+    void setCurve(size_t c, const std::vector<Point>& nodes)
+    {
+        for (int i = 0; i <= n; ++i)
+        {
+            x[i * padded + c] = (float) nodes[i].first;
+            y[i * padded + c] = (float) nodes[i].second;
+        }
+    }
+    Point node(size_t c, int i) const
+    {
+        return Point(x[i * padded + c], y[i * padded + c]);
+    }
+
+    // 在 t = 0, 1 / segments, ..., 1 上对所有曲线求值，
+    // 第 c 条曲线第 j 个点写入 out_x[j * stride() + c]、out_y[j * stride() + c]，
+    // 两个输出各需 (segments + 1) * stride() 个 float
+    void evaluate(int segments, float* out_x, float* out_y) const
+    {
+        static const Kernel kernel = selectKernel();
+        (this->*kernel)(segments, out_x, out_y);
+    }
+
+    // 第一次调用时按 CPU 选出 evaluate 使用的内核，name 返回内核名（"avx2" 或 "scalar"）
+    static Kernel selectKernel(const char** name = NULL)
+    {
+        static Kernel kernel = NULL;
+        static const char* kernel_name = "scalar";
+        if (!kernel)
+        {
+            kernel = &BezierBatch::evaluateScalar;
+#ifdef BEZIER_X86_SIMD
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            {
+                kernel = &BezierBatch::evaluateAVX2;
+                kernel_name = "avx2";
+            }
+#endif
+        }
+        if (name)
+            *name = kernel_name;
+        return kernel;
+    }
+
+    // 与 evaluateAVX2 相同的分块和循环顺序，每次一条曲线
+    void evaluateScalar(int segments, float* out_x, float* out_y) const
+    {
+        const std::vector<float>& w = weights(segments);
+        for (size_t block = 0; block < count; block += BLOCK)
+        {
+            size_t block_end = std::min(block + BLOCK, count);
+            for (int j = 0; j <= segments; ++j)
+            {
+                const float* wj = w.data() + j * (n + 1);
+                for (size_t c = block; c < block_end; ++c)
+                {
+                    float px = 0.0f, py = 0.0f;
+                    for (int i = 0; i <= n; ++i)
+                    {
+                        px += wj[i] * x[i * padded + c];
+                        py += wj[i] * y[i * padded + c];
+                    }
+                    out_x[j * padded + c] = px;
+                    out_y[j * padded + c] = py;
+                }
+            }
+        }
+    }
+
+#ifdef BEZIER_X86_SIMD
+    // 外层按 BLOCK 条曲线分块，这一块的控制点在所有采样点间一直留在 L1 中；
+    // 块内每个采样点连续写出 BLOCK 个 float，避免按 stride 跳着写单个向量造成缓存组冲突
+    __attribute__((target("avx2,fma")))
+    void evaluateAVX2(int segments, float* out_x, float* out_y) const
+    {
+        const std::vector<float>& w = weights(segments);
+        for (size_t block = 0; block < count; block += BLOCK)
+        {
+            size_t block_end = std::min(block + BLOCK, count);
+            for (int j = 0; j <= segments; ++j)
+            {
+                const float* wj = w.data() + j * (n + 1);
+                for (size_t c = block; c < block_end; c += 8)
+                {
+                    __m256 px = _mm256_setzero_ps(), py = _mm256_setzero_ps();
+                    for (int i = 0; i <= n; ++i)
+                    {
+                        __m256 weight = _mm256_broadcast_ss(wj + i);
+                        __m256 node_x = _mm256_loadu_ps(x.data() + i * padded + c);
+                        __m256 node_y = _mm256_loadu_ps(y.data() + i * padded + c);
+                        px = _mm256_fmadd_ps(weight, node_x, px);
+                        py = _mm256_fmadd_ps(weight, node_y, py);
+                    }
+                    _mm256_storeu_ps(out_x + j * padded + c, px);
+                    _mm256_storeu_ps(out_y + j * padded + c, py);
+                }
+            }
+        }
+    }
+#endif
+private:
+    int n;
+    size_t count;
+    size_t padded;
+    std::vector<float> x;
+    std::vector<float> y;
+    mutable int weight_segments;
+    mutable std::vector<float> weight_table;
+
+    // 权重表 w[j * (n + 1) + i] = B_{n, i}(j / segments)，在 double 中算好再转成 float，
+    // 采样数不变时复用
+    const std::vector<float>& weights(int segments) const
+    {
+        if (weight_segments != segments || (int) weight_table.size() != (segments + 1) * (n + 1))
+        {
+            const std::vector<double>& c = binomials(n);
+            weight_table.resize((segments + 1) * (n + 1));
+            for (int j = 0; j <= segments; ++j)
+            {
+                double t = (double) j / segments;
+                for (int i = 0; i <= n; ++i)
+                    weight_table[j * (n + 1) + i] = (float) (c[i] * std::pow(1.0 - t, n - i) * std::pow(t, i));
+            }
+            weight_segments = segments;
+        }
+        return weight_table;
+    }
+};
+
+#endif /* BezierBatch_h */
@@ -0,0 +1,87 @@
+//
+//  BezierBenchmark.cpp
+//  CG
+//
+//  不打开窗口，比较逐条曲线求值（bezierPoint）与 BezierBatch 的标量求值、evaluate 所选内核的批量求值，
+//  输出每秒求值的曲线数和相对 double 结果的最大误差。
+//  用法：BezierBenchmark [curves] [segments]，内核在运行时按 CPU 选择，-O2 编译即可
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Bezier.h"
+#include "BezierBatch.h"
+
+// 重复运行 f 至少 0.2 秒，返回每次的平均秒数
+template<typename F>
+double measure(F f)
+{
+    int runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds;
+    do
+    {
+        f();
+        ++runs;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < 0.2);
+    return seconds / runs;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t curves = argc > 1 ? (size_t) std::max(atoi(argv[1]), 1) : 10000;
+    int segments = argc > 2 ? std::max(atoi(argv[2]), 1) : 64;
+    const char* kernel_name;
+    BezierBatch::selectKernel(&kernel_name);
+    std::printf("%zu curves, %d segments, batch kernel %s\n", curves, segments, kernel_name);
+
+    std::mt19937 rng(2018);
+    std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+    for (int degree : {2, 3, 5, 7})
+    {
+        std::vector<std::vector<Point>> nodes(curves, std::vector<Point>(degree + 1));
+        BezierBatch batch(degree, curves);
+        for (size_t c = 0; c < curves; ++c)
+        {
+            for (Point& p : nodes[c])
+                p = Point(coordinate(rng), coordinate(rng));
+            batch.setCurve(c, nodes[c]);
+        }
+
+        std::vector<Point> points;
+        double aos = measure([&]()
+        {
+            for (size_t c = 0; c < curves; ++c)
+                sampleBezier(nodes[c], segments, points);
+        });
+        std::vector<float> out_x((segments + 1) * batch.stride()), out_y((segments + 1) * batch.stride());
+        double scalar = measure([&]()
+        {
+            batch.evaluateScalar(segments, out_x.data(), out_y.data());
+        });
+        double batched = measure([&]()
+        {
+            batch.evaluate(segments, out_x.data(), out_y.data());
+        });
+
+        // float 控制点与 float 权重带来的误差，与 double 的 Horner 结果比较
+        double error = 0.0;
+        for (size_t c = 0; c < curves; c += std::max(curves / 100, (size_t) 1))
+            for (int j = 0; j <= segments; ++j)
+            {
+                Point p = bezierPoint(nodes[c], (double) j / segments);
+                error = std::max(error, std::fabs(out_x[j * batch.stride() + c] - p.first));
+                error = std::max(error, std::fabs(out_y[j * batch.stride() + c] - p.second));
+            }
+
+        std::printf("degree %d: sampleBezier %.3g curves/s, batch scalar %.3g curves/s, batch %s %.3g curves/s (x%.1f), max error %.2g\n",
+                    degree, curves / aos, curves / scalar, kernel_name, curves / batched, aos / batched, error);
+    }
+    return 0;
+}
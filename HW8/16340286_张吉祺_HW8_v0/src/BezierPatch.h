@@ -0,0 +1,286 @@
+//
+//  BezierPatch.h
+//  CG
+//
+
+#ifndef BezierPatch_h
+#define BezierPatch_h
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "WorkerPool.h"
+
+// 双三次 Bézier 曲面片，nodes[i][j] 中 i 沿 u 方向，j 沿 v 方向
+struct BezierPatch {
+    glm::vec3 nodes[4][4];
+};
+
+// 细分得到的带索引三角网格。每个顶点为 x y z nx ny nz，与 HW6 的顶点格式相同；
+// 三角形逆时针时朝向 S_u × S_v
+struct PatchMesh {
+    std::vector<float> vertices;
+    std::vector<uint> indices;
+};
+
+// 把一批曲面片并行细分为一个网格。每片按 (level + 1)^2 的均匀网格取点，
+// level 由屏幕空间误差决定：用控制网的二阶差分估计网格与曲面之间的最大偏差，
+// 按曲面片到相机的距离投影到像素，超过 tolerance 就加倍，所以远处的曲面片只有几个三角形。
+// level 取 2 的幂；每条边另有只由这条边自己的 4 个控制点决定的级别，
+// 相邻曲面片在公共边上算出的级别相同，较细一侧的边上顶点吸附到较粗的折线上，拼接处没有裂缝
+class PatchTessellator {
+public:
+    static const int MAX_LEVEL = 64;
+
+    PatchTessellator(unsigned threads = std::thread::hardware_concurrency()):
+        pool(threads)
+    {
+        for (int level = 1; level <= MAX_LEVEL; level *= 2)
+        {
+            Basis basis;
+            for (int k = 0; k <= level; ++k)
+            {
+                float t = (float) k / level, s = 1.0f - t;
+                float values[4] = {s * s * s, 3 * t * s * s, 3 * t * t * s, t * t * t};
+                float derivatives[4] = {-3 * s * s, 3 * s * s - 6 * t * s, 6 * t * s - 3 * t * t, 3 * t * t};
+                basis.values.insert(basis.values.end(), values, values + 4);
+                basis.derivatives.insert(basis.derivatives.end(), derivatives, derivatives + 4);
+            }
+            bases.push_back(basis);
+        }
+    }
+    PatchTessellator(const PatchTessellator&) = delete;
+    PatchTessellator& operator=(const PatchTessellator&) = delete;
+
+    // eye 为相机位置（Camera::getCameraPos()），fovy 为透视投影的纵向视角（弧度），
+    // viewport_height 为视口高度（像素），tolerance 为允许的误差（像素）。结果覆盖写入 mesh
+    void tessellate(const std::vector<BezierPatch>& patches, const glm::vec3& eye, float fovy,
+                    float viewport_height, float tolerance, PatchMesh& mesh)
+    {
+        float pixels_per_unit = viewport_height / (2.0f * std::tan(fovy / 2.0f));
+        plans.resize(patches.size());
+        next = 0;
+        pool.run([&]()
+        {
+            for (size_t i; (i = next++) < patches.size(); )
+                plan(patches[i], eye, pixels_per_unit, tolerance, plans[i]);
+        });
+
+        size_t vertices = 0, indices = 0;
+        for (Plan& p : plans)
+        {
+            p.first_vertex = vertices;
+            p.first_index = indices;
+            vertices += (size_t) (p.level + 1) * (p.level + 1);
+            indices += (size_t) 6 * p.level * p.level;
+        }
+        mesh.vertices.resize(6 * vertices);
+        mesh.indices.resize(indices);
+
+        next = 0;
+        pool.run([&]()
+        {
+            for (size_t i; (i = next++) < patches.size(); )
+                build(patches[i], plans[i], mesh);
+        });
+    }
+
+    // 最近一次细分中第 i 片的级别（每边的段数）
+    int level(size_t i) const
+    {
+        return plans[i].level;
+    }
+    unsigned threadCount() const
+    {
+        return pool.threadCount();
+    }
+private:
+    // 在 t = k / level 处的 4 个 Bernstein 基函数及其导数
+    struct Basis {
+        std::vector<float> values;
+        std::vector<float> derivatives;
+    };
+    // edges 依次为 v = 0、u = 1、v = 1、u = 0 四条边的级别
+    struct Plan {
+        int level;
+        int edges[4];
+        size_t first_vertex;
+        size_t first_index;
+    };
+
+    WorkerPool pool;
+    std::vector<Basis> bases; // bases[k] 对应 level = 2^k
+    std::vector<Plan> plans;
+    std::atomic<size_t> next;
+
+    static int log2(int level)
+    {
+        int k = 0;
+        while ((1 << k) < level)
+            ++k;
+        return k;
+    }
+
+    // 二阶导数的上界为 m 时，步长 1 / level 的网格误差不超过 m / (8 level^2)
+    static int levelFor(float m, const glm::vec3& center, float radius, const glm::vec3& eye,
+                        float pixels_per_unit, float tolerance)
+    {
+        float distance = std::max(glm::length(center - eye) - radius, 1e-6f);
+        float allowed = tolerance * distance / pixels_per_unit;
+        float needed = std::sqrt(m / (8.0f * allowed));
+        int level = 1;
+        while (level < needed && level < MAX_LEVEL)
+            level *= 2;
+        return level;
+    }
+
+    static float secondDifference(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        return glm::length(a - 2.0f * b + c);
+    }
+
+    // 边的级别只由这条边上的 4 个控制点决定，先统一方向，保证相邻两片的计算完全相同
+    static int edgeLevel(glm::vec3 q[4], const glm::vec3& eye, float pixels_per_unit, float tolerance)
+    {
+        if (q[3].x < q[0].x || (q[3].x == q[0].x && (q[3].y < q[0].y || (q[3].y == q[0].y && q[3].z < q[0].z))))
+        {
+            std::swap(q[0], q[3]);
+            std::swap(q[1], q[2]);
+        }
+        float m = 6.0f * std::max(secondDifference(q[0], q[1], q[2]), secondDifference(q[1], q[2], q[3]));
+        glm::vec3 center = (q[0] + q[1] + q[2] + q[3]) * 0.25f;
+        float radius = 0.0f;
+        for (int i = 0; i < 4; ++i)
+            radius = std::max(radius, glm::length(q[i] - center));
+        return levelFor(m, center, radius, eye, pixels_per_unit, tolerance);
+    }
+
+    void plan(const BezierPatch& patch, const glm::vec3& eye, float pixels_per_unit, float tolerance, Plan& p) const
+    {
+        const glm::vec3 (*n)[4] = patch.nodes;
+        float m_uu = 0.0f, m_vv = 0.0f, m_uv = 0.0f;
+        glm::vec3 center(0.0f);
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+            {
+                if (i < 2)
+                    m_uu = std::max(m_uu, secondDifference(n[i][j], n[i + 1][j], n[i + 2][j]));
+                if (j < 2)
+                    m_vv = std::max(m_vv, secondDifference(n[i][j], n[i][j + 1], n[i][j + 2]));
+                if (i < 3 && j < 3)
+                    m_uv = std::max(m_uv, glm::length(n[i + 1][j + 1] - n[i + 1][j] - n[i][j + 1] + n[i][j]));
+                center += n[i][j];
+            }
+        center /= 16.0f;
+        float radius = 0.0f;
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                radius = std::max(radius, glm::length(n[i][j] - center));
+        // 三次曲线二阶导数不超过 6 倍二阶差分，混合导数不超过 9 倍混合差分
+        p.level = levelFor(6.0f * m_uu + 18.0f * m_uv + 6.0f * m_vv, center, radius, eye, pixels_per_unit, tolerance);
+
+        for (int e = 0; e < 4; ++e)
+        {
+            glm::vec3 q[4];
+            for (int k = 0; k < 4; ++k)
+                q[k] = e == 0 ? n[k][0] : e == 1 ? n[3][k] : e == 2 ? n[k][3] : n[0][k];
+            p.edges[e] = edgeLevel(q, eye, pixels_per_unit, tolerance);
+            p.level = std::max(p.level, p.edges[e]);
+        }
+    }
+
+    void build(const BezierPatch& patch, const Plan& p, PatchMesh& mesh) const
+    {
+        const glm::vec3 (*n)[4] = patch.nodes;
+        int level = p.level;
+        int stride = level + 1;
+        const Basis& basis = bases[log2(level)];
+        float* out = mesh.vertices.data() + 6 * p.first_vertex;
+        // 退化的角点（一条边缩成一点）上 S_u × S_v 为 0，改用控制网两条对角方向的法向
+        glm::vec3 fallback = glm::cross(n[3][0] - n[0][0] + n[3][3] - n[0][3], n[0][3] - n[0][0] + n[3][3] - n[3][0]);
+        float fallback_length = glm::length(fallback);
+        fallback = fallback_length > 0.0f ? fallback / fallback_length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+        for (int a = 0; a <= level; ++a)
+        {
+            // 先沿 u 求出 4 条 v 方向的曲线的控制点及其对 u 的导数
+            const float* bu = &basis.values[4 * a];
+            const float* du = &basis.derivatives[4 * a];
+            glm::vec3 c[4], dc[4];
+            for (int j = 0; j < 4; ++j)
+            {
+                c[j] = bu[0] * n[0][j] + bu[1] * n[1][j] + bu[2] * n[2][j] + bu[3] * n[3][j];
+                dc[j] = du[0] * n[0][j] + du[1] * n[1][j] + du[2] * n[2][j] + du[3] * n[3][j];
+            }
+            for (int b = 0; b <= level; ++b)
+            {
+                const float* bv = &basis.values[4 * b];
+                const float* dv = &basis.derivatives[4 * b];
+                glm::vec3 s = bv[0] * c[0] + bv[1] * c[1] + bv[2] * c[2] + bv[3] * c[3];
+                glm::vec3 s_u = bv[0] * dc[0] + bv[1] * dc[1] + bv[2] * dc[2] + bv[3] * dc[3];
+                glm::vec3 s_v = dv[0] * c[0] + dv[1] * c[1] + dv[2] * c[2] + dv[3] * c[3];
+                glm::vec3 normal = glm::cross(s_u, s_v);
+                float length = glm::length(normal);
+                normal = length > 1e-6f * glm::length(s_u) * glm::length(s_v) && length > 0.0f ? normal / length : fallback;
+                float* v = out + 6 * (a * stride + b);
+                v[0] = s.x;
+                v[1] = s.y;
+                v[2] = s.z;
+                v[3] = normal.x;
+                v[4] = normal.y;
+                v[5] = normal.z;
+            }
+        }
+
+        // 边的级别较低时，不在粗网格上的边顶点吸附到粗折线上
+        for (int e = 0; e < 4; ++e)
+        {
+            int step = level / p.edges[e];
+            if (step == 1)
+                continue;
+            for (int k = 0; k < level; ++k)
+            {
+                int offset = k % step;
+                if (offset == 0)
+                    continue;
+                float* v = out + 6 * edgeVertex(e, k, level);
+                const float* lo = out + 6 * edgeVertex(e, k - offset, level);
+                const float* hi = out + 6 * edgeVertex(e, k - offset + step, level);
+                float f = (float) offset / step;
+                for (int i = 0; i < 3; ++i)
+                    v[i] = (1.0f - f) * lo[i] + f * hi[i];
+            }
+        }
+
+        uint* indices = mesh.indices.data() + p.first_index;
+        for (int a = 0; a < level; ++a)
+            for (int b = 0; b < level; ++b)
+            {
+                uint v00 = (uint) (p.first_vertex + a * stride + b);
+                uint v10 = v00 + stride;
+                uint v11 = v10 + 1;
+                uint v01 = v00 + 1;
+                uint quad[6] = {v00, v10, v11, v00, v11, v01};
+                indices = std::copy(quad, quad + 6, indices);
+            }
+    }
+
+    // 第 e 条边上第 k 个顶点在本片网格中的下标
+    static int edgeVertex(int e, int k, int level)
+    {
+        int stride = level + 1;
+        switch (e)
+        {
+            case 0: return k * stride;
+            case 1: return level * stride + k;
+            case 2: return k * stride + level;
+            default: return k;
+        }
+    }
+};
+
+#endif /* BezierPatch_h */
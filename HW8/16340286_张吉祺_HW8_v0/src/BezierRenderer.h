@@ -0,0 +1,289 @@
+//
+//  BezierRenderer.h
+//  CG
+//
+
+#ifndef BezierRenderer_h
+#define BezierRenderer_h
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "Bezier.h"
+
+// 在顶点着色器中求 Bézier 曲线。控制点放在 uniform buffer 中，每个点为 (x, y, C(n, i), 0)；
+// 顶点只有一个静态的参数 t，每条曲线是一个实例，实例属性给出它在 buffer 中的起点和次数。
+// 与 bezierPoint 相同，t <= 0.5 时对 u = t / (1 - t) 用 Horner 法，t > 0.5 时对称处理
+const char* const bezierVertexShaderSource = "#version 330 core\n"
+"layout (location = 0) in float t;\n"
+"layout (location = 1) in ivec2 curve;\n"
+"layout (std140) uniform Nodes\n"
+"{\n"
+"   vec4 nodes[1024];\n"
+"};\n"
+"void main()\n"
+"{\n"
+"   int first = curve.x;\n"
+"   int n = curve.y;\n"
+"   bool reverse = t > 0.5;\n"
+"   float s = reverse ? t : 1.0 - t;\n"
+"   float u = reverse ? (1.0 - t) / t : t / (1.0 - t);\n"
+"   vec2 p = vec2(0.0);\n"
+"   for (int k = n; k >= 0; --k)\n"
+"   {\n"
+"       vec4 node = nodes[first + (reverse ? n - k : k)];\n"
+"       p = p * u + node.z * node.xy;\n"
+"   }\n"
+"   gl_Position = vec4(p * pow(s, float(n)), 0.0, 1.0);\n"
+"}\0";
+
+const char* const bezierFragmentShaderSource = "#version 330 core\n"
+"out vec4 FragColor;\n"
+"uniform vec3 color;\n"
+"void main()\n"
+"{\n"
+"   FragColor = vec4(color, 1.0);\n"
+"}\n\0";
+
+inline uint compileProgram(const char* vertexShaderSource, const char* fragmentShaderSource)
+{
+    int success;
+    char infoLog[512];
+    int vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+    glCompileShader(vertexShader);
+    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    
+    int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+    glCompileShader(fragmentShader);
+    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    
+    uint shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glLinkProgram(shaderProgram);
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+    }
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return shaderProgram;
+}
+
+// 需要 OpenGL 3.3（uniform buffer、实例化、整数属性），创建前用 available() 检查。
+// 添加曲线时上传整条曲线的控制点，移动一个控制点只需 setNode 更新 16 字节
+class BezierRenderer {
+public:
+    // uniform buffer 的容量，16 KB 是 GL 保证的最小值，需与着色器中的数组大小一致
+    static const int MAX_NODES = 1024;
+    // 单条曲线的最高次数，更高时 float 的二项式系数与 s^n 会失去精度，交给 CPU 细分
+    static const int MAX_DEGREE = 63;
+
+    static bool available()
+    {
+        return GLAD_GL_VERSION_3_3 != 0;
+    }
+
+    BezierRenderer(int segments = 1000):
+        segments(segments),
+        used(0)
+    {
+        shaderProgram = compileProgram(bezierVertexShaderSource, bezierFragmentShaderSource);
+        glUniformBlockBinding(shaderProgram, glGetUniformBlockIndex(shaderProgram, "Nodes"), 0);
+        colorLocation = glGetUniformLocation(shaderProgram, "color");
+
+        std::vector<float> parameters(segments + 1);
+        for (int i = 0; i <= segments; ++i)
+            parameters[i] = (float) i / segments;
+        parameters[segments] = 1.0f;
+
+        glGenBuffers(1, &UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferData(GL_UNIFORM_BUFFER, MAX_NODES * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &parameterVBO);
+        glGenBuffers(1, &curveVBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, parameterVBO);
+        glBufferData(GL_ARRAY_BUFFER, parameters.size() * sizeof(float), parameters.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0); // t
+        glBindBuffer(GL_ARRAY_BUFFER, curveVBO);
+        glVertexAttribIPointer(1, 2, GL_INT, 2 * sizeof(GLint), (void*)0);
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(1); // curve
+        glBindBuffer(GL_ARRAY_BUFFER, 0); // unbind VBO
+        glBindVertexArray(0); // unbind VAO
+    }
+    ~BezierRenderer()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &parameterVBO);
+        glDeleteBuffers(1, &curveVBO);
+        glDeleteBuffers(1, &UBO);
+        glDeleteProgram(shaderProgram);
+    }
+    BezierRenderer(const BezierRenderer&) = delete;
+    BezierRenderer& operator=(const BezierRenderer&) = delete;
+
+    void clear()
+    {
+        curves.clear();
+        used = 0;
+    }
+
+    // 返回曲线编号；次数过高或 buffer 已满时返回 -1，调用者应改用 CPU 细分
+    int addCurve(const std::vector<Point>& nodes)
+    {
+        int n = (int) nodes.size() - 1;
+        if (n < 0 || n > MAX_DEGREE || used + n + 1 > MAX_NODES)
+            return -1;
+        const std::vector<double>& c = binomials(n);
+        std::vector<float> data(4 * (n + 1), 0.0f);
+        for (int i = 0; i <= n; ++i)
+        {
+            data[4 * i] = (float) nodes[i].first;
+            data[4 * i + 1] = (float) nodes[i].second;
+            data[4 * i + 2] = (float) c[i];
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, used * 4 * sizeof(float), data.size() * sizeof(float), data.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        curves.push_back(used);
+        curves.push_back(n);
+        used += n + 1;
+        glBindBuffer(GL_ARRAY_BUFFER, curveVBO);
+        glBufferData(GL_ARRAY_BUFFER, curves.size() * sizeof(GLint), curves.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return (int) curves.size() / 2 - 1;
+    }
+
+    // 移动第 curve 条曲线的第 i 个控制点，系数不变，只更新 x、y
+    void setNode(int curve, int i, const Point& p)
+    {
+        float xy[2] = {(float) p.first, (float) p.second};
+        glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, (curves[2 * curve] + i) * 4 * sizeof(float), sizeof(xy), xy);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // 所有曲线一次实例化绘制，每条曲线是 segments 段的折线
+    void draw(float r, float g, float b)
+    {
+        if (curves.empty())
+            return;
+        glUseProgram(shaderProgram);
+        glUniform3f(colorLocation, r, g, b);
+        glBindBufferBase(GL_UNIFORM_BUFFER, 0, UBO);
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_LINE_STRIP, 0, segments + 1, (GLsizei) curves.size() / 2);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+private:
+    int segments;
+    int used;
+    std::vector<GLint> curves; // 每条曲线的 (起点, 次数)
+    uint shaderProgram;
+    GLint colorLocation;
+    uint VAO, parameterVBO, curveVBO, UBO;
+};
+
+const char* const polylineVertexShaderSource = "#version 330 core\n"
+"layout (location = 0) in vec2 aPos;\n"
+"void main()\n"
+"{\n"
+"   gl_Position = vec4(aPos, 0.0, 1.0);\n"
+"}\0";
+
+// CPU 上算好的折线（如 UniformBSpline::points）的 GPU 副本。
+// update 只上传变化的区间，容量不够时按两倍扩大并整体上传一次
+class PolylineBuffer {
+public:
+    PolylineBuffer():
+        capacity(0),
+        count(0)
+    {
+        shaderProgram = compileProgram(polylineVertexShaderSource, bezierFragmentShaderSource);
+        colorLocation = glGetUniformLocation(shaderProgram, "color");
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0); // pos
+        glBindBuffer(GL_ARRAY_BUFFER, 0); // unbind VBO
+        glBindVertexArray(0); // unbind VAO
+    }
+    ~PolylineBuffer()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteProgram(shaderProgram);
+    }
+    PolylineBuffer(const PolylineBuffer&) = delete;
+    PolylineBuffer& operator=(const PolylineBuffer&) = delete;
+
+    // points 的顶点数可能已经改变，[first, last) 之外的顶点与上次上传的相同
+    void update(const std::vector<Point>& points, size_t first, size_t last)
+    {
+        count = points.size();
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if (count > capacity)
+        {
+            capacity = std::max(capacity * 2, count);
+            glBufferData(GL_ARRAY_BUFFER, capacity * 2 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+            first = 0;
+            last = count;
+        }
+        if (first < last)
+        {
+            scratch.resize(2 * (last - first));
+            for (size_t i = first; i < last; ++i)
+            {
+                scratch[2 * (i - first)] = (float) points[i].first;
+                scratch[2 * (i - first) + 1] = (float) points[i].second;
+            }
+            glBufferSubData(GL_ARRAY_BUFFER, first * 2 * sizeof(float), scratch.size() * sizeof(float), scratch.data());
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void draw(float r, float g, float b)
+    {
+        if (count < 2)
+            return;
+        glUseProgram(shaderProgram);
+        glUniform3f(colorLocation, r, g, b);
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_LINE_STRIP, 0, (GLsizei) count);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+private:
+    size_t capacity, count;
+    std::vector<float> scratch;
+    uint shaderProgram;
+    GLint colorLocation;
+    uint VAO, VBO;
+};
+
+#endif /* BezierRenderer_h */
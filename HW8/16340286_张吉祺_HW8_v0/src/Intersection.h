@@ -0,0 +1,389 @@
+//
+//  Intersection.h
+//  CG
+//
+
+#ifndef Intersection_h
+#define Intersection_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Bezier.h"
+
+// Bézier 曲线与线段、曲线与曲线的交点。
+// 用控制点的包围盒 / 凸包做细分：包围盒不相交、或曲线到直线的有向距离全同号时整块丢弃，
+// 剩下的小块足够平直后用弦求出近似交点，再对原曲线做 Newton 迭代，得到精确到舍入误差的参数
+
+// t 为第一条曲线上的参数；与线段求交时 u 为线段 p0 + u (p1 - p0) 上的参数，否则为第二条曲线上的参数
+struct CurveHit {
+    double t;
+    double u;
+    Point point;
+};
+
+// 求导矢的控制点 n (P_{i + 1} - P_i)
+inline void bezierDerivative(const std::vector<Point>& nodes, std::vector<Point>& derivative)
+{
+    int n = (int) nodes.size() - 1;
+    derivative.clear();
+    for (int i = 0; i < n; ++i)
+        derivative.push_back(Point(n * (nodes[i + 1].first - nodes[i].first), n * (nodes[i + 1].second - nodes[i].second)));
+}
+
+// 细分时两个交点的参数相差小于此值视为同一个
+const double HIT_MERGE_DISTANCE = 1e-7;
+
+inline void addHit(std::vector<CurveHit>& hits, size_t first, const CurveHit& hit)
+{
+    for (size_t i = first; i < hits.size(); ++i)
+        if (std::fabs(hits[i].t - hit.t) < HIT_MERGE_DISTANCE && std::fabs(hits[i].u - hit.u) < HIT_MERGE_DISTANCE)
+            return;
+    hits.push_back(hit);
+}
+
+// 曲线到直线的有向距离是以 d_i 为系数的一维 Bézier 函数，在 t 上按 de Casteljau 对半分
+inline void splitScalar(const double* d, int n, double* left, double* right)
+{
+    for (int i = 0; i <= n; ++i)
+        right[i] = d[i];
+    for (int level = 1; level <= n; ++level)
+    {
+        left[level - 1] = right[0];
+        for (int i = 0; i <= n - level; ++i)
+            right[i] = (right[i] + right[i + 1]) * 0.5;
+    }
+    left[n] = right[0];
+}
+
+inline double evaluateScalar(const double* d, int n, double t, double* scratch)
+{
+    for (int i = 0; i <= n; ++i)
+        scratch[i] = d[i];
+    for (int level = 1; level <= n; ++level)
+        for (int i = 0; i <= n - level; ++i)
+            scratch[i] = (1 - t) * scratch[i] + t * scratch[i + 1];
+    return scratch[0];
+}
+
+// 在 [t0, t1] 上找 d(t) 的根。系数全同号时无根；系数单调时恰有一根，直接在区间内求；
+// 否则对半细分。full 为整条曲线的系数，用于在原参数上求值
+inline void scalarRoots(const double* d, int n, double t0, double t1, int depth,
+                        const double* full, double* scratch, std::vector<double>& roots)
+{
+    bool positive = false, negative = false, increasing = true, decreasing = true;
+    for (int i = 0; i <= n; ++i)
+    {
+        positive = positive || d[i] > 0.0;
+        negative = negative || d[i] < 0.0;
+        if (i > 0)
+        {
+            increasing = increasing && d[i] >= d[i - 1];
+            decreasing = decreasing && d[i] <= d[i - 1];
+        }
+    }
+    if (!(positive && negative))
+    {
+        // 端点恰好为 0 时是根，由相邻区间的端点记录
+        if (d[0] == 0.0)
+            roots.push_back(t0);
+        if (d[n] == 0.0)
+            roots.push_back(t1);
+        return;
+    }
+    if (increasing || decreasing || depth >= 2 * MAX_SUBDIVISION_DEPTH)
+    {
+        // 单调时 d(t) 在区间内只有一个根，用试位法（Illinois 变形）求，不会跑出区间
+        double a = t0, b = t1;
+        double fa = d[0], fb = d[n];
+        int side = 0;
+        for (int iteration = 0; iteration < 100 && b - a > 1e-15; ++iteration)
+        {
+            double c = (a * fb - b * fa) / (fb - fa);
+            double fc = evaluateScalar(full, n, c, scratch);
+            if (fc == 0.0)
+            {
+                a = b = c;
+                break;
+            }
+            if ((fc > 0.0) == (fb > 0.0))
+            {
+                b = c;
+                fb = fc;
+                if (side == -1)
+                    fa *= 0.5;
+                side = -1;
+            }
+            else
+            {
+                a = c;
+                fa = fc;
+                if (side == 1)
+                    fb *= 0.5;
+                side = 1;
+            }
+        }
+        roots.push_back((a + b) * 0.5);
+        return;
+    }
+    double* left = scratch + (n + 1);
+    double* right = left + (n + 1);
+    splitScalar(d, n, left, right);
+    double middle = (t0 + t1) * 0.5;
+    scalarRoots(left, n, t0, middle, depth + 1, full, right + (n + 1), roots);
+    scalarRoots(right, n, middle, t1, depth + 1, full, right + (n + 1), roots);
+}
+
+// 曲线与线段 p0 p1 的交点，结果追加到 hits，按 t 递增
+inline void intersectCurveLine(const std::vector<Point>& nodes, const Point& p0, const Point& p1,
+                               std::vector<CurveHit>& hits)
+{
+    int n = (int) nodes.size() - 1;
+    double dx = p1.first - p0.first, dy = p1.second - p0.second;
+    double length2 = dx * dx + dy * dy;
+    if (n < 1 || length2 == 0.0)
+        return;
+    std::vector<double> d(n + 1);
+    for (int i = 0; i <= n; ++i)
+        d[i] = dx * (nodes[i].second - p0.second) - dy * (nodes[i].first - p0.first);
+    std::vector<double> scratch((n + 1) * (3 * (2 * MAX_SUBDIVISION_DEPTH + 2)));
+    std::vector<double> roots;
+    scalarRoots(d.data(), n, 0.0, 1.0, 0, d.data(), scratch.data(), roots);
+    std::sort(roots.begin(), roots.end());
+    size_t first = hits.size();
+    for (double t : roots)
+    {
+        Point p = bezierPoint(nodes, t);
+        double u = (dx * (p.first - p0.first) + dy * (p.second - p0.second)) / length2;
+        // 线段端点处留一点余量，避免恰好过端点的交点因舍入被漏掉
+        if (u >= -1e-12 && u <= 1.0 + 1e-12)
+            addHit(hits, first, CurveHit{t, std::min(std::max(u, 0.0), 1.0), p});
+    }
+}
+
+// 两条弦 a0 a1、b0 b1 的交点参数，平行时返回 false
+inline bool intersectChords(const Point& a0, const Point& a1, const Point& b0, const Point& b1, double& s, double& r)
+{
+    double ax = a1.first - a0.first, ay = a1.second - a0.second;
+    double bx = b1.first - b0.first, by = b1.second - b0.second;
+    double det = ax * by - ay * bx;
+    if (det == 0.0)
+        return false;
+    double cx = b0.first - a0.first, cy = b0.second - a0.second;
+    s = (cx * by - cy * bx) / det;
+    r = (cx * ay - cy * ax) / det;
+    return true;
+}
+
+// 由近似参数出发，对 A(t) - B(u) = 0 做 Newton 迭代；收敛到交点时返回 true
+inline bool refineHit(const std::vector<Point>& a, const std::vector<Point>& da,
+                      const std::vector<Point>& b, const std::vector<Point>& db,
+                      double tolerance, CurveHit& hit)
+{
+    double t = hit.t, u = hit.u;
+    for (int iteration = 0; iteration < 16; ++iteration)
+    {
+        Point pa = bezierPoint(a, t), pb = bezierPoint(b, u);
+        double fx = pa.first - pb.first, fy = pa.second - pb.second;
+        if (fx == 0.0 && fy == 0.0)
+            break;
+        Point ta = bezierPoint(da, t), tb = bezierPoint(db, u);
+        // J = [A'(t), -B'(u)]
+        double det = -ta.first * tb.second + ta.second * tb.first;
+        if (std::fabs(det) < 1e-300)
+            break;
+        double step_t = (-fx * -tb.second - -fy * -tb.first) / det;
+        double step_u = (ta.first * -fy - ta.second * -fx) / det;
+        t = std::min(std::max(t + step_t, 0.0), 1.0);
+        u = std::min(std::max(u + step_u, 0.0), 1.0);
+        if (std::fabs(step_t) < 1e-15 && std::fabs(step_u) < 1e-15)
+            break;
+    }
+    Point pa = bezierPoint(a, t), pb = bezierPoint(b, u);
+    // 相切时 Newton 收敛很慢，只要两点距离在容差内仍然接受
+    if (std::hypot(pa.first - pb.first, pa.second - pb.second) > tolerance)
+        return false;
+    hit = CurveHit{t, u, Point((pa.first + pb.first) * 0.5, (pa.second + pb.second) * 0.5)};
+    return true;
+}
+
+struct BoundingBox {
+    double x_min, y_min, x_max, y_max;
+};
+
+inline BoundingBox boundingBox(const Point* p, int n)
+{
+    BoundingBox box{p[0].first, p[0].second, p[0].first, p[0].second};
+    for (int i = 1; i <= n; ++i)
+    {
+        box.x_min = std::min(box.x_min, p[i].first);
+        box.x_max = std::max(box.x_max, p[i].first);
+        box.y_min = std::min(box.y_min, p[i].second);
+        box.y_max = std::max(box.y_max, p[i].second);
+    }
+    return box;
+}
+
+inline bool overlaps(const BoundingBox& a, const BoundingBox& b, double margin)
+{
+    return a.x_min <= b.x_max + margin && b.x_min <= a.x_max + margin &&
+           a.y_min <= b.y_max + margin && b.y_min <= a.y_max + margin;
+}
+
+// 两段子曲线 a（参数 [t0, t1]）与 b（[u0, u1]）的包围盒不相交则丢弃；
+// 都足够平直时用弦求交点，否则把较大的一段对半分
+inline void intersectPieces(const Point* a, int n, double t0, double t1,
+                            const Point* b, int m, double u0, double u1,
+                            int depth, double tolerance, Point* scratch, std::vector<CurveHit>& candidates)
+{
+    BoundingBox box_a = boundingBox(a, n), box_b = boundingBox(b, m);
+    if (!overlaps(box_a, box_b, tolerance))
+        return;
+    bool flat_a = bezierFlatness(a, n, 1.0, 1.0) <= tolerance;
+    bool flat_b = bezierFlatness(b, m, 1.0, 1.0) <= tolerance;
+    if ((flat_a && flat_b) || depth >= 4 * MAX_SUBDIVISION_DEPTH)
+    {
+        double s, r;
+        if (intersectChords(a[0], a[n], b[0], b[m], s, r) &&
+            s >= -0.5 && s <= 1.5 && r >= -0.5 && r <= 1.5)
+        {
+            // 弦的交点可能略微落在本段之外，交给 Newton 修正
+            s = std::min(std::max(s, 0.0), 1.0);
+            r = std::min(std::max(r, 0.0), 1.0);
+            candidates.push_back(CurveHit{t0 + s * (t1 - t0), u0 + r * (u1 - u0), Point(0.0, 0.0)});
+        }
+        return;
+    }
+    double size_a = std::max(box_a.x_max - box_a.x_min, box_a.y_max - box_a.y_min);
+    double size_b = std::max(box_b.x_max - box_b.x_min, box_b.y_max - box_b.y_min);
+    if (!flat_a && (flat_b || size_a >= size_b))
+    {
+        Point* left = scratch;
+        Point* right = scratch + (n + 1);
+        splitBezier(a, n, left, right);
+        double middle = (t0 + t1) * 0.5;
+        Point* next = right + (n + 1);
+        intersectPieces(left, n, t0, middle, b, m, u0, u1, depth + 1, tolerance, next, candidates);
+        intersectPieces(right, n, middle, t1, b, m, u0, u1, depth + 1, tolerance, next, candidates);
+    }
+    else
+    {
+        Point* left = scratch;
+        Point* right = scratch + (m + 1);
+        splitBezier(b, m, left, right);
+        double middle = (u0 + u1) * 0.5;
+        Point* next = right + (m + 1);
+        intersectPieces(a, n, t0, t1, left, m, u0, middle, depth + 1, tolerance, next, candidates);
+        intersectPieces(a, n, t0, t1, right, m, middle, u1, depth + 1, tolerance, next, candidates);
+    }
+}
+
+// 两条曲线的交点，结果追加到 hits，按 t 递增。
+// tolerance 为细分停止时子曲线允许的弯曲程度（与控制点同单位），也是相切时接受交点的距离；
+// 默认值约为 800 x 600 窗口中的 0.04 像素
+inline void intersectCurves(const std::vector<Point>& a, const std::vector<Point>& b, std::vector<CurveHit>& hits,
+                            double tolerance = 1e-4)
+{
+    int n = (int) a.size() - 1, m = (int) b.size() - 1;
+    if (n < 1 || m < 1)
+        return;
+    std::vector<Point> scratch(2 * std::max(n + 1, m + 1) * (4 * MAX_SUBDIVISION_DEPTH + 1));
+    std::vector<CurveHit> candidates;
+    intersectPieces(a.data(), n, 0.0, 1.0, b.data(), m, 0.0, 1.0, 0, tolerance, scratch.data(), candidates);
+    if (candidates.empty())
+        return;
+    std::vector<Point> da, db;
+    bezierDerivative(a, da);
+    bezierDerivative(b, db);
+    std::vector<CurveHit> refined;
+    for (CurveHit hit : candidates)
+        if (refineHit(a, da, b, db, tolerance, hit))
+            addHit(refined, 0, hit);
+    std::sort(refined.begin(), refined.end(), [](const CurveHit& x, const CurveHit& y) { return x.t < y.t; });
+    hits.insert(hits.end(), refined.begin(), refined.end());
+}
+
+// 一组曲线上的批量查询。各曲线控制点的包围盒预先算好；
+// 两两求交时按包围盒左端排序后扫描，只有包围盒在 x 上重叠的曲线对才进一步检查
+class CurveSet {
+public:
+    // first、second 为曲线编号，与线段求交时 second 为 -1
+    struct Hit {
+        int first;
+        int second;
+        CurveHit hit;
+    };
+
+    int add(const std::vector<Point>& nodes)
+    {
+        curves.push_back(nodes);
+        boxes.push_back(nodes.empty() ? BoundingBox{0.0, 0.0, -1.0, -1.0} : boundingBox(nodes.data(), (int) nodes.size() - 1));
+        return (int) curves.size() - 1;
+    }
+    void set(int i, const std::vector<Point>& nodes)
+    {
+        curves[i] = nodes;
+        boxes[i] = nodes.empty() ? BoundingBox{0.0, 0.0, -1.0, -1.0} : boundingBox(nodes.data(), (int) nodes.size() - 1);
+    }
+    size_t size() const
+    {
+        return curves.size();
+    }
+    const std::vector<Point>& curve(int i) const
+    {
+        return curves[i];
+    }
+
+    // 线段 p0 p1 与所有曲线的交点（点击测试、吸附）
+    void intersectLine(const Point& p0, const Point& p1, std::vector<Hit>& out) const
+    {
+        BoundingBox line{std::min(p0.first, p1.first), std::min(p0.second, p1.second),
+                         std::max(p0.first, p1.first), std::max(p0.second, p1.second)};
+        std::vector<CurveHit> hits;
+        for (size_t i = 0; i < curves.size(); ++i)
+        {
+            if (!overlaps(boxes[i], line, 0.0))
+                continue;
+            hits.clear();
+            intersectCurveLine(curves[i], p0, p1, hits);
+            for (const CurveHit& hit : hits)
+                out.push_back(Hit{(int) i, -1, hit});
+        }
+    }
+
+    // 所有曲线两两之间的交点（布尔运算）
+    void intersectAll(std::vector<Hit>& out, double tolerance = 1e-4) const
+    {
+        std::vector<int> order(curves.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = (int) i;
+        std::sort(order.begin(), order.end(), [this](int x, int y) { return boxes[x].x_min < boxes[y].x_min; });
+        std::vector<int> active;
+        std::vector<CurveHit> hits;
+        for (int i : order)
+        {
+            // 去掉右端已在当前曲线左端之前的
+            size_t kept = 0;
+            for (int j : active)
+                if (boxes[j].x_max + tolerance >= boxes[i].x_min)
+                    active[kept++] = j;
+            active.resize(kept);
+            for (int j : active)
+            {
+                if (!overlaps(boxes[i], boxes[j], tolerance))
+                    continue;
+                int first = std::min(i, j), second = std::max(i, j);
+                hits.clear();
+                intersectCurves(curves[first], curves[second], hits, tolerance);
+                for (const CurveHit& hit : hits)
+                    out.push_back(Hit{first, second, hit});
+            }
+            active.push_back(i);
+        }
+    }
+private:
+    std::vector<std::vector<Point>> curves;
+    std::vector<BoundingBox> boxes;
+};
+
+#endif /* Intersection_h */
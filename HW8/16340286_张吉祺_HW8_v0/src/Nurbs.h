@@ -0,0 +1,298 @@
+//
+//  Nurbs.h
+//  CG
+//
+
+#ifndef Nurbs_h
+#define Nurbs_h
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Bezier.h"
+
+// 有理 Bézier 曲线。控制点 P_i 带正权重 w_i，在齐次坐标 (w x, w y, w) 下是普通的多项式 Bézier，
+// 所以直接用 bezierPoint / splitBezier：xy 存 (w x, w y)，weight 存 (w, 0)，两者分别求值后相除。
+// 权重为正时曲线仍在控制点的凸包内，bezierFlatness 对投影后的控制点同样是误差上界
+class RationalBezier {
+public:
+    RationalBezier(const std::vector<Point>& nodes, const std::vector<double>& weights)
+    {
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            xy.push_back(Point(weights[i] * nodes[i].first, weights[i] * nodes[i].second));
+            weight.push_back(Point(weights[i], 0.0));
+        }
+    }
+
+    int degree() const
+    {
+        return (int) xy.size() - 1;
+    }
+    Point node(int i) const
+    {
+        return Point(xy[i].first / weight[i].first, xy[i].second / weight[i].first);
+    }
+    double nodeWeight(int i) const
+    {
+        return weight[i].first;
+    }
+
+    Point point(double t) const
+    {
+        Point h = bezierPoint(xy, t);
+        double w = bezierPoint(weight, t).first;
+        return Point(h.first / w, h.second / w);
+    }
+
+    // 升一阶，曲线不变：Q_i = i / (n + 1) H_{i - 1} + (1 - i / (n + 1)) H_i（齐次坐标）
+    void elevateDegree()
+    {
+        elevate(xy);
+        elevate(weight);
+    }
+
+    // 与 tessellateBezier 相同的自适应细分，覆盖写入 points
+    void tessellate(double tolerance, double scale_x, double scale_y, std::vector<Point>& points) const
+    {
+        points.clear();
+        if (xy.empty())
+            return;
+        points.push_back(node(0));
+        appendTessellation(tolerance, scale_x, scale_y, points);
+    }
+    // 只追加起点之后的顶点，用于把多段首尾相接的曲线拼成一条折线
+    void appendTessellation(double tolerance, double scale_x, double scale_y, std::vector<Point>& points) const
+    {
+        int n = degree();
+        if (n <= 0)
+            return;
+        std::vector<Point> scratch(5 * (n + 1) * (MAX_SUBDIVISION_DEPTH + 1));
+        tessellate(xy.data(), weight.data(), n, 0, tolerance, scale_x, scale_y, scratch.data(), points);
+    }
+private:
+    std::vector<Point> xy;
+    std::vector<Point> weight;
+
+    static void elevate(std::vector<Point>& h)
+    {
+        int n = (int) h.size() - 1;
+        std::vector<Point> e(n + 2);
+        e[0] = h[0];
+        e[n + 1] = h[n];
+        for (int i = 1; i <= n; ++i)
+        {
+            double a = (double) i / (n + 1);
+            e[i] = Point(a * h[i - 1].first + (1 - a) * h[i].first, a * h[i - 1].second + (1 - a) * h[i].second);
+        }
+        h.swap(e);
+    }
+
+    // 每层在 scratch 中占用 5(n + 1) 个点：投影后的控制点，以及 xy、weight 各自的左右两半
+    static void tessellate(const Point* xy, const Point* w, int n, int depth, double tolerance,
+                           double scale_x, double scale_y, Point* scratch, std::vector<Point>& points)
+    {
+        Point* projected = scratch;
+        for (int i = 0; i <= n; ++i)
+            projected[i] = Point(xy[i].first / w[i].first, xy[i].second / w[i].first);
+        if (depth >= MAX_SUBDIVISION_DEPTH || bezierFlatness(projected, n, scale_x, scale_y) <= tolerance)
+        {
+            points.push_back(projected[n]);
+            return;
+        }
+        Point* left_xy = scratch + (n + 1);
+        Point* right_xy = scratch + 2 * (n + 1);
+        Point* left_w = scratch + 3 * (n + 1);
+        Point* right_w = scratch + 4 * (n + 1);
+        splitBezier(xy, n, left_xy, right_xy);
+        splitBezier(w, n, left_w, right_w);
+        tessellate(left_xy, left_w, n, depth + 1, tolerance, scale_x, scale_y, scratch + 5 * (n + 1), points);
+        tessellate(right_xy, right_w, n, depth + 1, tolerance, scale_x, scale_y, scratch + 5 * (n + 1), points);
+    }
+};
+
+// 非均匀有理 B 样条。degree 次，控制点 nodes 与正权重 weights 各 n + 1 个，
+// 节点向量 knots 共 n + degree + 2 个，非递减，且两端各重复 degree + 1 次（曲线过首尾控制点）。
+// 求值用齐次坐标下的 de Boor 算法；绘制时先插入节点分解为有理 Bézier 段，再逐段自适应细分。
+// 圆、圆弧等二次曲线可以精确表示，比用多项式 Bézier 逼近少得多的控制点
+class Nurbs {
+public:
+    Nurbs(int degree, const std::vector<Point>& nodes, const std::vector<double>& weights,
+          const std::vector<double>& knots):
+        p(degree),
+        knot(knots)
+    {
+        for (size_t i = 0; i < nodes.size(); ++i)
+            h.push_back(Homogeneous{weights[i] * nodes[i].first, weights[i] * nodes[i].second, weights[i]});
+    }
+
+    // 以 (c_x, c_y) 为圆心、r 为半径的整圆：二次，9 个控制点，四个角上的权重为 √2 / 2
+    static Nurbs circle(double c_x, double c_y, double r)
+    {
+        const double corner = std::sqrt(0.5);
+        std::vector<Point> nodes;
+        std::vector<double> weights;
+        const int dx[9] = {1, 1, 0, -1, -1, -1, 0, 1, 1};
+        const int dy[9] = {0, 1, 1, 1, 0, -1, -1, -1, 0};
+        for (int i = 0; i < 9; ++i)
+        {
+            nodes.push_back(Point(c_x + r * dx[i], c_y + r * dy[i]));
+            weights.push_back(i % 2 ? corner : 1.0);
+        }
+        std::vector<double> knots = {0, 0, 0, 0.25, 0.25, 0.5, 0.5, 0.75, 0.75, 1, 1, 1};
+        return Nurbs(2, nodes, weights, knots);
+    }
+
+    int degree() const
+    {
+        return p;
+    }
+    int nodeCount() const
+    {
+        return (int) h.size();
+    }
+    Point node(int i) const
+    {
+        return Point(h[i].x / h[i].w, h[i].y / h[i].w);
+    }
+    double nodeWeight(int i) const
+    {
+        return h[i].w;
+    }
+    const std::vector<double>& knots() const
+    {
+        return knot;
+    }
+    // 参数范围 [knots[degree], knots[n + 1]]
+    double first() const
+    {
+        return knot[p];
+    }
+    double last() const
+    {
+        return knot[h.size()];
+    }
+
+    Point point(double u) const
+    {
+        int k = span(u);
+        std::vector<Homogeneous>& d = scratch;
+        d.assign(h.begin() + (k - p), h.begin() + (k + 1));
+        for (int r = 1; r <= p; ++r)
+            for (int j = p; j >= r; --j)
+            {
+                double alpha = (u - knot[j + k - p]) / (knot[j + 1 + k - r] - knot[j + k - p]);
+                d[j] = lerp(d[j - 1], d[j], alpha);
+            }
+        return Point(d[p].x / d[p].w, d[p].y / d[p].w);
+    }
+
+    // Boehm 算法插入一个节点，曲线形状不变，多一个控制点
+    void insertKnot(double u)
+    {
+        int k = span(u);
+        std::vector<Homogeneous> q(h.size() + 1);
+        for (int i = 0; i <= k - p; ++i)
+            q[i] = h[i];
+        for (int i = k - p + 1; i <= k; ++i)
+            q[i] = lerp(h[i - 1], h[i], (u - knot[i]) / (knot[i + p] - knot[i]));
+        for (int i = k; i < (int) h.size(); ++i)
+            q[i + 1] = h[i];
+        h.swap(q);
+        knot.insert(knot.begin() + k + 1, u);
+    }
+
+    // 把每个内部节点插到 degree 重，之后每 degree + 1 个控制点是一段有理 Bézier
+    void toBezier(std::vector<RationalBezier>& segments) const
+    {
+        segments.clear();
+        Nurbs split = *this;
+        for (size_t i = p + 1; i < split.h.size(); )
+        {
+            double u = split.knot[i];
+            size_t multiplicity = 1;
+            while (i + multiplicity < split.h.size() && split.knot[i + multiplicity] == u)
+                ++multiplicity;
+            for (; multiplicity < (size_t) p; ++multiplicity)
+                split.insertKnot(u);
+            i += multiplicity;
+        }
+        std::vector<Point> nodes(p + 1);
+        std::vector<double> weights(p + 1);
+        for (size_t first = 0; first + p < split.h.size(); first += p)
+        {
+            for (int i = 0; i <= p; ++i)
+            {
+                nodes[i] = split.node((int) first + i);
+                weights[i] = split.h[first + i].w;
+            }
+            segments.push_back(RationalBezier(nodes, weights));
+        }
+    }
+
+    // 升一阶：分解为有理 Bézier 段后逐段升阶再拼接。
+    // 内部节点变为 degree + 1 重，没有做节点消去，所以控制点会比最少的多
+    void elevateDegree()
+    {
+        std::vector<RationalBezier> segments;
+        toBezier(segments);
+        std::vector<double> breaks;
+        for (size_t i = p; i <= h.size(); ++i)
+            if (breaks.empty() || knot[i] != breaks.back())
+                breaks.push_back(knot[i]);
+        ++p;
+        h.clear();
+        knot.assign(p + 1, breaks.front());
+        for (size_t s = 0; s < segments.size(); ++s)
+        {
+            segments[s].elevateDegree();
+            for (int i = s == 0 ? 0 : 1; i <= p; ++i)
+            {
+                Point n = segments[s].node(i);
+                double w = segments[s].nodeWeight(i);
+                h.push_back(Homogeneous{w * n.first, w * n.second, w});
+            }
+            knot.insert(knot.end(), s + 1 < segments.size() ? p : p + 1, breaks[s + 1]);
+        }
+    }
+
+    // 逐段自适应细分，拼成一条折线，覆盖写入 points
+    void tessellate(double tolerance, double scale_x, double scale_y, std::vector<Point>& points) const
+    {
+        std::vector<RationalBezier> segments;
+        toBezier(segments);
+        points.clear();
+        if (segments.empty())
+            return;
+        points.push_back(segments[0].node(0));
+        for (const RationalBezier& segment : segments)
+            segment.appendTessellation(tolerance, scale_x, scale_y, points);
+    }
+private:
+    struct Homogeneous {
+        double x, y, w;
+    };
+
+    int p;
+    std::vector<Homogeneous> h;
+    std::vector<double> knot;
+    mutable std::vector<Homogeneous> scratch;
+
+    static Homogeneous lerp(const Homogeneous& a, const Homogeneous& b, double t)
+    {
+        return Homogeneous{(1 - t) * a.x + t * b.x, (1 - t) * a.y + t * b.y, (1 - t) * a.w + t * b.w};
+    }
+
+    // knots[k] <= u < knots[k + 1] 的 k，u 在参数范围的右端时取最后一个非空区间
+    int span(double u) const
+    {
+        int n = (int) h.size() - 1;
+        if (u >= knot[n + 1])
+            return n;
+        if (u <= knot[p])
+            return p;
+        return (int) (std::upper_bound(knot.begin() + p, knot.begin() + n + 2, u) - knot.begin()) - 1;
+    }
+};
+
+#endif /* Nurbs_h */
@@ -0,0 +1,282 @@
+//
+//  SpatialIndex.h
+//  CG
+//
+
+#ifndef SpatialIndex_h
+#define SpatialIndex_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Bezier.h"
+
+// 二维均匀网格上的空间索引，保存点（控制点）和线段（细分后曲线的各段），编号由调用者给出。
+// 格子用散列表存放，只有非空的格子占内存，坐标范围不限。
+// 插入、删除、移动都只改动涉及的格子；查询只看查询圆覆盖的格子，
+// 格子大小与拾取半径相当时，点分布不太极端的情况下每次查询只看常数个格子
+class SpatialGrid {
+public:
+    SpatialGrid(double cell_size):
+        cell(cell_size)
+    {
+    }
+
+    void insertPoint(int id, const Point& p)
+    {
+        if (id >= (int) points.size())
+            points.resize(id + 1, PointEntry{Point(0.0, 0.0), 0, -1});
+        long long key = keyOf(cellOf(p.first), cellOf(p.second));
+        std::vector<int>& bucket = point_cells[key];
+        points[id] = PointEntry{p, key, (int) bucket.size()};
+        bucket.push_back(id);
+    }
+    void removePoint(int id)
+    {
+        if (id >= (int) points.size() || points[id].slot < 0)
+            return;
+        PointEntry& entry = points[id];
+        auto found = point_cells.find(entry.key);
+        std::vector<int>& bucket = found->second;
+        // 与最后一个交换后删除，被移动的点更新自己的位置
+        int moved = bucket.back();
+        bucket[entry.slot] = moved;
+        points[moved].slot = entry.slot;
+        bucket.pop_back();
+        if (bucket.empty())
+            point_cells.erase(found);
+        entry.slot = -1;
+    }
+    // 不在索引中的点直接插入
+    void movePoint(int id, const Point& p)
+    {
+        if (id < (int) points.size() && points[id].slot >= 0 &&
+            keyOf(cellOf(p.first), cellOf(p.second)) == points[id].key)
+        {
+            points[id].position = p;
+            return;
+        }
+        removePoint(id);
+        insertPoint(id, p);
+    }
+
+    void insertSegment(int id, const Point& a, const Point& b)
+    {
+        if (id >= (int) segments.size())
+            segments.resize(id + 1, SegmentEntry{Point(0.0, 0.0), Point(0.0, 0.0), false});
+        segments[id] = SegmentEntry{a, b, true};
+        forSegmentCells(a, b, [this, id](long long key)
+        {
+            segment_cells[key].push_back(id);
+        });
+    }
+    void removeSegment(int id)
+    {
+        if (id >= (int) segments.size() || !segments[id].present)
+            return;
+        SegmentEntry& entry = segments[id];
+        forSegmentCells(entry.a, entry.b, [this, id](long long key)
+        {
+            auto found = segment_cells.find(key);
+            std::vector<int>& bucket = found->second;
+            bucket.erase(std::find(bucket.begin(), bucket.end(), id));
+            if (bucket.empty())
+                segment_cells.erase(found);
+        });
+        entry.present = false;
+    }
+    // 不在索引中的线段直接插入
+    void moveSegment(int id, const Point& a, const Point& b)
+    {
+        removeSegment(id);
+        insertSegment(id, a, b);
+    }
+
+    // 距离 p 不超过 radius 的最近点，没有则返回 -1。按格子环由内向外找，
+    // 找到的点比下一环的最近可能距离还近时停止；
+    // 环上的格子比非空格子还多时（点很稀疏或 radius 很大），改为直接遍历所有非空格子
+    int nearestPoint(const Point& p, double radius) const
+    {
+        int cx = cellOf(p.first), cy = cellOf(p.second);
+        double rings = std::ceil(radius / cell) + 1;
+        int best = -1;
+        double best_distance2 = radius * radius;
+        auto visit = [&](const std::vector<int>& bucket)
+        {
+            for (int id : bucket)
+            {
+                double d2 = distance2(points[id].position, p);
+                if (d2 <= best_distance2 && (best < 0 || d2 < best_distance2 || id < best))
+                {
+                    best = id;
+                    best_distance2 = d2;
+                }
+            }
+        };
+        for (int ring = 0; ring <= rings; ++ring)
+        {
+            // 第 ring 环中的点至少相距 (ring - 1) 个格子
+            double inner = (ring - 1) * cell;
+            if (ring > 0 && best >= 0 && inner * inner > best_distance2)
+                break;
+            if (8.0 * ring > point_cells.size())
+            {
+                for (auto& bucket : point_cells)
+                    visit(bucket.second);
+                break;
+            }
+            forRing(cx, cy, ring, [&](long long key)
+            {
+                auto found = point_cells.find(key);
+                if (found != point_cells.end())
+                    visit(found->second);
+            });
+        }
+        return best;
+    }
+
+    // 距离 p 不超过 radius 的所有点，追加到 out
+    void pointsInRadius(const Point& p, double radius, std::vector<int>& out) const
+    {
+        forBox(p, radius, [&](long long key)
+        {
+            auto found = point_cells.find(key);
+            if (found == point_cells.end())
+                return;
+            for (int id : found->second)
+                if (distance2(points[id].position, p) <= radius * radius)
+                    out.push_back(id);
+        });
+    }
+
+    // 距离 p 不超过 radius 的最近线段，没有则返回 -1
+    int nearestSegment(const Point& p, double radius) const
+    {
+        int best = -1;
+        double best_distance2 = radius * radius;
+        forBox(p, radius, [&](long long key)
+        {
+            auto found = segment_cells.find(key);
+            if (found == segment_cells.end())
+                return;
+            for (int id : found->second)
+            {
+                double d2 = segmentDistance2(segments[id], p);
+                if (d2 <= best_distance2 && (best < 0 || d2 < best_distance2 || id < best))
+                {
+                    best = id;
+                    best_distance2 = d2;
+                }
+            }
+        });
+        return best;
+    }
+
+    // 距离 p 不超过 radius 的所有线段，追加到 out，每段只出现一次
+    void segmentsInRadius(const Point& p, double radius, std::vector<int>& out) const
+    {
+        size_t first = out.size();
+        forBox(p, radius, [&](long long key)
+        {
+            auto found = segment_cells.find(key);
+            if (found == segment_cells.end())
+                return;
+            for (int id : found->second)
+                if (segmentDistance2(segments[id], p) <= radius * radius)
+                    out.push_back(id);
+        });
+        std::sort(out.begin() + first, out.end());
+        out.erase(std::unique(out.begin() + first, out.end()), out.end());
+    }
+
+    void clear()
+    {
+        points.clear();
+        segments.clear();
+        point_cells.clear();
+        segment_cells.clear();
+    }
+private:
+    struct PointEntry {
+        Point position;
+        long long key;
+        int slot; // 在格子中的下标，-1 表示不在索引中
+    };
+    struct SegmentEntry {
+        Point a, b;
+        bool present;
+    };
+
+    double cell;
+    std::vector<PointEntry> points;
+    std::vector<SegmentEntry> segments;
+    std::unordered_map<long long, std::vector<int>> point_cells;
+    std::unordered_map<long long, std::vector<int>> segment_cells;
+
+    int cellOf(double v) const
+    {
+        return (int) std::floor(v / cell);
+    }
+    // 在无符号数上拼接，负的格子坐标左移不是未定义行为
+    static long long keyOf(int x, int y)
+    {
+        return (long long) (((unsigned long long) (uint32_t) x << 32) | (uint32_t) y);
+    }
+    static double distance2(const Point& a, const Point& b)
+    {
+        double dx = a.first - b.first, dy = a.second - b.second;
+        return dx * dx + dy * dy;
+    }
+    static double segmentDistance2(const SegmentEntry& s, const Point& p)
+    {
+        double dx = s.b.first - s.a.first, dy = s.b.second - s.a.second;
+        double length2 = dx * dx + dy * dy;
+        double t = length2 > 0.0 ? ((p.first - s.a.first) * dx + (p.second - s.a.second) * dy) / length2 : 0.0;
+        t = std::min(std::max(t, 0.0), 1.0);
+        return distance2(Point(s.a.first + t * dx, s.a.second + t * dy), p);
+    }
+
+    // 线段包围盒覆盖的格子。细分出的曲线段都很短，包围盒只有一两个格子
+    template<typename F>
+    void forSegmentCells(const Point& a, const Point& b, F f) const
+    {
+        int x0 = cellOf(std::min(a.first, b.first)), x1 = cellOf(std::max(a.first, b.first));
+        int y0 = cellOf(std::min(a.second, b.second)), y1 = cellOf(std::max(a.second, b.second));
+        for (int x = x0; x <= x1; ++x)
+            for (int y = y0; y <= y1; ++y)
+                f(keyOf(x, y));
+    }
+    template<typename F>
+    void forBox(const Point& p, double radius, F f) const
+    {
+        int x0 = cellOf(p.first - radius), x1 = cellOf(p.first + radius);
+        int y0 = cellOf(p.second - radius), y1 = cellOf(p.second + radius);
+        for (int x = x0; x <= x1; ++x)
+            for (int y = y0; y <= y1; ++y)
+                f(keyOf(x, y));
+    }
+    // 以 (cx, cy) 为中心、切比雪夫距离为 ring 的一圈格子
+    template<typename F>
+    void forRing(int cx, int cy, int ring, F f) const
+    {
+        if (ring == 0)
+        {
+            f(keyOf(cx, cy));
+            return;
+        }
+        for (int x = cx - ring; x <= cx + ring; ++x)
+        {
+            f(keyOf(x, cy - ring));
+            f(keyOf(x, cy + ring));
+        }
+        for (int y = cy - ring + 1; y <= cy + ring - 1; ++y)
+        {
+            f(keyOf(cx - ring, y));
+            f(keyOf(cx + ring, y));
+        }
+    }
+};
+
+#endif /* SpatialIndex_h */
@@ -0,0 +1,94 @@
+//
+//  WorkerPool.h
+//  CG
+//
+
+#ifndef WorkerPool_h
+#define WorkerPool_h
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 与 HW3 Rasterizer.h 中的 WorkerPool 相同：线程在构造时创建，run 把同一个任务交给所有线程
+// （包括调用线程）并等待全部完成，任务内部自己用原子计数器分配工作
+class WorkerPool {
+public:
+    WorkerPool(unsigned threads = std::thread::hardware_concurrency()):
+        generation(0),
+        busy(0),
+        quit(false),
+        job(NULL)
+    {
+        // 调用线程也参与工作，所以额外只需 threads - 1 个
+        for (unsigned i = 1; i < threads; ++i)
+            workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void run(const std::function<void()>& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &task;
+            busy = (int) workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+        task();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        job = NULL;
+    }
+    unsigned threadCount() const
+    {
+        return (unsigned) workers.size() + 1;
+    }
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned long generation;
+    int busy;
+    bool quit;
+    const std::function<void()>* job;
+
+    void workerLoop()
+    {
+        unsigned long seen = 0;
+        while (true)
+        {
+            const std::function<void()>* task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen] { return quit || generation != seen; });
+                if (quit)
+                    return;
+                seen = generation;
+                task = job;
+            }
+            (*task)();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --busy;
+            }
+            done.notify_one();
+        }
+    }
+};
+
+#endif /* WorkerPool_h */
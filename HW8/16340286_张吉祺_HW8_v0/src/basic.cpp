@@ -3,118 +3,314 @@
 #include <iostream>
 #include <vector>
 #include <math.h>
+#include <algorithm>
+#include <ctime>
+#include "Batch2D.h"
+#include "Bezier.h"
+#include "BezierRenderer.h"
+#include "BSpline.h"
+#include "SpatialIndex.h"
 
 const uint SCR_WIDTH = 800;
 const uint SCR_HEIGHT = 600;
 
 double move_x, move_y;
 
-std::vector<std::pair<double, double>> main_nodes;
-std::vector<std::pair<double, double>> bezier_points;
+std::vector<Point> main_nodes;
+std::vector<Point> bezier_points;
+// 控制点、控制线和 CPU 细分的曲线都先放进 batch，每帧一两次 draw call
+Batch2D* batch = NULL;
+// OpenGL 3.3 可用时在 GPU 上求曲线，否则为 NULL，用 CPU 细分出的 bezier_points
+BezierRenderer* gpu_curve = NULL;
+// 当前曲线是否在 GPU 上求值
+bool gpu_bezier = false;
 
-void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
+// B 键切换为均匀三次 B 样条，适合很多控制点的长路径：每次编辑只重算附近几段
+bool spline_mode = false;
+UniformBSpline spline;
+PolylineBuffer* gpu_spline = NULL;
+
+// 正在拖动的控制点，-1 表示没有
+int dragging = -1;
+
+// 控制点和 B 样条折线各段在屏幕坐标（像素）下的网格索引，编号分别为下标。
+// 每次编辑只更新变化的几项，光标悬停时的查询与控制点个数无关
+const double PICK_RADIUS = 6.0;
+SpatialGrid node_index(2 * PICK_RADIUS);
+SpatialGrid spline_index(2 * PICK_RADIUS);
+int indexed_segments = 0;
+// 光标下的控制点和 B 样条段（第几段），-1 表示没有
+int hover_node = -1;
+int hover_segment = -1;
+
+// 画面是否需要重画。只有输入改变了状态时才置位，静止时主循环阻塞在 glfwWaitEventsTimeout 中，
+// 不再每帧重画和交换缓冲
+bool dirty = true;
+// 没有事件时最长等待的时间（秒）
+const double IDLE_TIMEOUT = 0.5;
+
+// 折线与曲线之间允许的最大偏差（像素）
+const double FLATNESS_TOLERANCE = 0.25;
+
+// 按屏幕上的平直度自适应细分，代替原来固定的 t += 0.001：
+// 平直的部分只有几个顶点，弯曲的部分自动加密
+void make_bezier()
 {
-    move_x = xpos;
-    move_y = ypos;
+    if (gpu_curve)
+    {
+        gpu_curve->clear();
+        gpu_bezier = gpu_curve->addCurve(main_nodes) >= 0;
+        if (gpu_bezier)
+        {
+            bezier_points.clear();
+            return;
+        }
+    }
+    tessellateBezier(main_nodes, FLATNESS_TOLERANCE, SCR_WIDTH / 2.0, SCR_HEIGHT / 2.0, bezier_points);
 }
 
-double factorial(int n)
+Point to_pixels(const Point& p)
 {
-    int fact = 1;
-    for (int i = 1; i <= n; ++i)
-        fact = fact * i;
-    return (double) fact;
+    return Point((p.first + 1.0) * SCR_WIDTH / 2, (1.0 - p.second) * SCR_HEIGHT / 2);
 }
 
-void make_bezier()
+// 只把 B 样条变化的区间上传到 GPU，并重新登记这些顶点所在的折线段
+void update_spline()
+{
+    const std::vector<Point>& points = spline.points();
+    if (gpu_spline)
+        gpu_spline->update(points, spline.dirtyFirst(), spline.dirtyLast());
+    int segments = std::max((int) points.size() - 1, 0);
+    for (int i = segments; i < indexed_segments; ++i)
+        spline_index.removeSegment(i);
+    int first = std::max((int) spline.dirtyFirst() - 1, 0);
+    int last = std::min((int) spline.dirtyLast(), segments);
+    for (int i = first; i < last; ++i)
+        spline_index.moveSegment(i, to_pixels(points[i]), to_pixels(points[i + 1]));
+    indexed_segments = segments;
+    spline.clearDirty();
+}
+
+// 控制点增删之后：B 样条总是增量更新，整条 Bézier 曲线只在显示时重建
+void nodes_changed()
 {
-    bezier_points.clear();
-    int n = (int) main_nodes.size() - 1;
-    for (double t = 0; t <= 1; t += 0.001)
+    update_spline();
+    if (!spline_mode)
+        make_bezier();
+}
+
+void move_node(int index, const Point& p)
+{
+    main_nodes[index] = p;
+    node_index.movePoint(index, to_pixels(p));
+    spline.move(index, p);
+    update_spline();
+    if (spline_mode)
+        return;
+    // 控制点个数不变，GPU 上的曲线只需更新这一个点
+    if (gpu_bezier)
+        gpu_curve->setNode(0, index, p);
+    else
+        make_bezier();
+}
+
+Point cursor_point()
+{
+    return Point(2 * move_x / SCR_WIDTH - 1.0f, 1.0f - 2 * move_y / SCR_HEIGHT);
+}
+
+// 光标落在哪个控制点上（控制点画成 12 像素），没有则返回 -1；
+// 不在控制点上时记下光标下的 B 样条段
+// 高亮改变时需要重画
+void update_hover()
+{
+    Point cursor(move_x, move_y);
+    int node = node_index.nearestPoint(cursor, PICK_RADIUS);
+    int segment = node < 0 && spline_mode ? spline_index.nearestSegment(cursor, PICK_RADIUS) : -1;
+    segment = segment >= 0 ? segment / UniformBSpline::SAMPLES : -1;
+    if (node != hover_node || segment != hover_segment)
+        dirty = true;
+    hover_node = node;
+    hover_segment = segment;
+}
+
+void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
+{
+    move_x = xpos;
+    move_y = ypos;
+    if (dragging >= 0)
     {
-        double x = 0, y = 0;
-        for (int i = 0; i <= n; ++i)
-        {
-            double B = factorial(n) / factorial(i) / factorial(n - i) *
-            pow(t, i) * pow((1 - t), (n - i));
-            x += main_nodes[i].first * B;
-            y += main_nodes[i].second * B;
-        }
-        bezier_points.push_back(std::pair<double, double>(x, y));
+        move_node(dragging, cursor_point());
+        dirty = true;
     }
+    update_hover();
 }
 
+// 左键点在控制点上时拖动它，否则添加控制点；右键删除最后一个控制点
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
+    if (action == GLFW_RELEASE)
+    {
+        if (button == GLFW_MOUSE_BUTTON_LEFT)
+            dragging = -1;
+        return;
+    }
     if (action == GLFW_PRESS)
     {
         switch (button)
         {
             case GLFW_MOUSE_BUTTON_LEFT:
-                main_nodes.push_back(std::pair<double, double>(2 * move_x / SCR_WIDTH - 1.0f, 1.0f - 2 * move_y / SCR_HEIGHT));
+                dragging = hover_node;
+                if (dragging >= 0)
+                    return;
+                main_nodes.push_back(cursor_point());
+                node_index.insertPoint((int) main_nodes.size() - 1, Point(move_x, move_y));
+                spline.push_back(cursor_point());
                 break;
             case GLFW_MOUSE_BUTTON_RIGHT:
+                if (main_nodes.empty())
+                    return;
+                node_index.removePoint((int) main_nodes.size() - 1);
                 main_nodes.pop_back();
+                spline.pop_back();
+                dragging = -1;
                 break;
         }
-        make_bezier();
+        nodes_changed();
+        dirty = true;
+        update_hover();
+    }
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_B && action == GLFW_PRESS)
+    {
+        spline_mode = !spline_mode;
+        if (!spline_mode)
+            make_bezier();
+        dirty = true;
+        update_hover();
     }
 }
 
+// 窗口被遮挡后重新露出、缩放等，内容需要重画
+void window_refresh_callback(GLFWwindow* window)
+{
+    dirty = true;
+}
+
 void draw_fixed()
 {
     glClearColor (0.85, 0.85, 0.85, 0.0);
     glClear(GL_COLOR_BUFFER_BIT);
     
-    glPointSize(12.0f);
-    glBegin(GL_POINTS);
-    glColor3f(0.4, 0.4, 0.4);
+    BatchColor grey(0.4, 0.4, 0.4), blue(0.0, 0.4, 1.0), red(1.0, 0.0, 0.0);
     for (auto i : main_nodes)
     {
-        glVertex2f(i.first, i.second);
+        batch->point(i.first, i.second, 12.0f, grey);
+    }
+    if (hover_node >= 0)
+        batch->point(main_nodes[hover_node].first, main_nodes[hover_node].second, 12.0f, blue);
+    
+    // 光标下的 B 样条段加粗
+    if (hover_segment >= 0)
+    {
+        const std::vector<Point>& points = spline.points();
+        batch->beginPolyline();
+        for (int i = hover_segment * UniformBSpline::SAMPLES; i <= (hover_segment + 1) * UniformBSpline::SAMPLES; ++i)
+        {
+            batch->polylineVertex(points[i].first, points[i].second, 6.0f, blue);
+        }
+        batch->endPolyline();
     }
-    glEnd();
     
-    glLineWidth(2.0f);
-    glBegin(GL_LINES);
-    glColor3f(0.4, 0.4, 0.4);
     for (int i = 1; i < main_nodes.size(); ++i)
     {
-        glVertex2f(main_nodes[i - 1].first, main_nodes[i - 1].second);
-        glVertex2f(main_nodes[i].first, main_nodes[i].second);
+        batch->line(main_nodes[i - 1].first, main_nodes[i - 1].second, main_nodes[i].first, main_nodes[i].second, 2.0f, grey);
+    }
+    
+    if ((spline_mode && gpu_spline) || (!spline_mode && gpu_bezier))
+    {
+        // 曲线在 GPU 上求值，先画出控制点和控制线，保持曲线在最上面
+        batch->flush();
+        if (spline_mode)
+            gpu_spline->draw(1.0, 0.0, 0.0);
+        else
+            gpu_curve->draw(1.0, 0.0, 0.0);
+        return;
     }
-    glEnd();
     
-    glPointSize(2.0f);
-    glBegin(GL_POINTS);
-    glColor3f(1.0, 0.0, 0.0);
-    for (auto i : bezier_points)
+    // 顶点稀疏，用折线连起来
+    batch->beginPolyline();
+    for (auto i : spline_mode ? spline.points() : bezier_points)
     {
-        glVertex2f(i.first, i.second);
+        batch->polylineVertex(i.first, i.second, 2.0f, red);
     }
-    glEnd();
+    batch->endPolyline();
+    batch->flush();
 }
 
 
 int main()
 {
     glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
     
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "CG_HW8", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
     glfwMakeContextCurrent(window);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    batch = new Batch2D(SCR_WIDTH, SCR_HEIGHT);
+    if (BezierRenderer::available())
+    {
+        gpu_curve = new BezierRenderer();
+        gpu_spline = new PolylineBuffer();
+    }
+    
+    glfwSwapInterval(1);
+    glfwSetCursorPosCallback(window, cursor_position_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
     
+    // 退出时报告重画次数和进程占用的 CPU 时间，静止时应接近 0%
+    unsigned long frames = 0;
+    double start_time = glfwGetTime();
+    std::clock_t start_clock = std::clock();
     while (!glfwWindowShouldClose(window))
     {
-        draw_fixed();
-        
-        glfwSetCursorPosCallback(window, cursor_position_callback);
-        glfwSetMouseButtonCallback(window, mouse_button_callback);
-        
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (dirty)
+        {
+            dirty = false;
+            draw_fixed();
+            glfwSwapBuffers(window);
+            ++frames;
+        }
+        glfwWaitEventsTimeout(IDLE_TIMEOUT);
     }
+    double seconds = glfwGetTime() - start_time;
+    double cpu_seconds = (double) (std::clock() - start_clock) / CLOCKS_PER_SEC;
+    std::cout << frames << " frames in " << seconds << " s, CPU " << 100.0 * cpu_seconds / seconds << "%" << std::endl;
     
+    delete batch;
+    delete gpu_curve;
+    delete gpu_spline;
     glfwTerminate();
     return 0;
 }
@@ -3,16 +3,38 @@
 #include <iostream>
 #include <vector>
 #include <math.h>
+#include <ctime>
+#include "ArcLength.h"
+#include "Batch2D.h"
+#include "Bezier.h"
 
 const uint SCR_WIDTH = 800;
 const uint SCR_HEIGHT = 600;
 
 double move_x, move_y;
 
-std::vector<std::pair<double, double>> main_nodes;
-std::vector<std::pair<double, double>> bezier_points;
+std::vector<Point> main_nodes;
+std::vector<Point> bezier_points;
+DeCasteljau construction;
+// 控制点、构造过程和已画出的曲线点都放进 batch，每帧一次 draw call
+Batch2D* batch = NULL;
+// 控制点的弧长表，动画按弧长匀速推进，控制点改变时失效
+ArcLength arc_length;
+
+// 走完整条曲线所用的时间（秒）。原来每帧 t += 0.001，60 帧/秒时约为 16.7 秒，且速度随帧率和曲率变化
+const double ANIMATION_SECONDS = 1000 / 60.0;
 
 bool drawing = false;
+// 已经走过的弧长，按实际经过的时间推进，与帧率无关
+double distance = 0.0;
+bool finished = false;
+double last_time = 0.0;
+
+// 画面是否需要重画。动画进行时每帧都画，其余时间只在输入改变了状态时重画，
+// 静止时主循环阻塞在 glfwWaitEventsTimeout 中
+bool dirty = true;
+// 没有事件时最长等待的时间（秒）
+const double IDLE_TIMEOUT = 0.5;
 
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
 {
@@ -20,134 +42,167 @@ void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
     move_y = ypos;
 }
 
-void draw_process(std::vector<std::pair<double, double>> nodes, double t)
+// 画出 t 处 de Casteljau 构造的各中间层，并记录曲线上的点。
+// 所有层在 construction 的缓冲区中一次迭代算出，每帧不再复制控制点、不再分配内存
+void draw_process(const std::vector<Point>& nodes, double t)
 {
     if (nodes.size() < 2)
         return;
-    std::vector<std::pair<double, double>> next_nodes;
-    for (int i = 0; i < nodes.size() - 1; ++i)
-    {
-        double x = (1 - t) * nodes[i].first + t * nodes[i + 1].first;
-        double y = (1 - t) * nodes[i].second + t * nodes[i + 1].second;
-        next_nodes.push_back(std::pair<double, double>(x, y));
-    }
-    if (next_nodes.size() == 1)
+    construction.evaluate(nodes, t);
+    int n = construction.degree();
+    
+    BatchColor grey(0.6, 0.6, 0.6);
+    for (int k = 1; k < n; ++k)
     {
-        glPointSize(12.0f);
-        glBegin(GL_POINTS);
-        glColor3f(1.0, 0.0, 0.0);
-        glVertex2f(next_nodes[0].first, next_nodes[0].second);
-        glEnd();
-
-        bezier_points.push_back(next_nodes[0]);
-    }
-    else
-    {
-        for (int i = 0; i < next_nodes.size() - 1; ++i)
-        {
-            glLineWidth(2.0f);
-            glBegin(GL_LINES);
-            glColor3f(0.6, 0.6, 0.6);
-            for (int i = 1; i < next_nodes.size(); ++i)
-            {
-                glVertex2f(next_nodes[i - 1].first, next_nodes[i - 1].second);
-                glVertex2f(next_nodes[i].first, next_nodes[i].second);
-            }
-            glEnd();
-        }
-        draw_process(next_nodes, t);
+        const Point* level = construction.level(k);
+        batch->beginPolyline();
+        for (int i = 0; i < construction.levelSize(k); ++i)
+            batch->polylineVertex(level[i].first, level[i].second, 2.0f, grey);
+        batch->endPolyline();
     }
+    
+    const Point& p = construction.point();
+    batch->point(p.first, p.second, 12.0f, BatchColor(1.0, 0.0, 0.0));
+    
+    bezier_points.push_back(p);
 }
 
+// 动画进行时不响应鼠标
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
-    if (action == GLFW_PRESS)
+    if (action == GLFW_PRESS && !drawing)
     {
         switch (button)
         {
             case GLFW_MOUSE_BUTTON_LEFT:
-                main_nodes.push_back(std::pair<double, double>(2 * move_x / SCR_WIDTH - 1.0f, 1.0f - 2 * move_y / SCR_HEIGHT));
+                main_nodes.push_back(Point(2 * move_x / SCR_WIDTH - 1.0f, 1.0f - 2 * move_y / SCR_HEIGHT));
                 break;
             case GLFW_MOUSE_BUTTON_RIGHT:
-                main_nodes.pop_back();
+                if (!main_nodes.empty())
+                    main_nodes.pop_back();
                 break;
         }
+        arc_length.invalidate();
+        dirty = true;
+    }
+}
+
+// 回车开始或结束动画。原来每帧查询按键，按住时每帧都会切换一次
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_ENTER && action == GLFW_PRESS)
+    {
+        drawing = !drawing;
+        bezier_points.clear();
+        distance = 0.0;
+        finished = false;
+        // 等待事件的时间不计入动画
+        last_time = glfwGetTime();
+        dirty = true;
     }
 }
 
+// 窗口被遮挡后重新露出、缩放等，内容需要重画
+void window_refresh_callback(GLFWwindow* window)
+{
+    dirty = true;
+}
+
 void draw_fixed()
 {
     glClearColor (0.85, 0.85, 0.85, 0.0);
     glClear(GL_COLOR_BUFFER_BIT);
     
-    glPointSize(12.0f);
-    glBegin(GL_POINTS);
-    glColor3f(0.4, 0.4, 0.4);
+    BatchColor grey(0.4, 0.4, 0.4), red(1.0, 0.0, 0.0);
     for (auto i : main_nodes)
     {
-        glVertex2f(i.first, i.second);
+        batch->point(i.first, i.second, 12.0f, grey);
     }
-    glEnd();
     
-    glLineWidth(2.0f);
-    glBegin(GL_LINES);
-    glColor3f(0.4, 0.4, 0.4);
     for (int i = 1; i < main_nodes.size(); ++i)
     {
-        glVertex2f(main_nodes[i - 1].first, main_nodes[i - 1].second);
-        glVertex2f(main_nodes[i].first, main_nodes[i].second);
+        batch->line(main_nodes[i - 1].first, main_nodes[i - 1].second, main_nodes[i].first, main_nodes[i].second, 2.0f, grey);
     }
-    glEnd();
     
-    glPointSize(2.0f);
-    glBegin(GL_POINTS);
-    glColor3f(1.0, 0.0, 0.0);
     for (auto i : bezier_points)
     {
-        glVertex2f(i.first, i.second);
+        batch->point(i.first, i.second, 2.0f, red);
     }
-    glEnd();
 }
 
 
 int main()
 {
     glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
     
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "CG_HW8", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
     glfwMakeContextCurrent(window);
-    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    batch = new Batch2D(SCR_WIDTH, SCR_HEIGHT);
     
-    double current_t = 0.0;
+    glfwSwapInterval(1);
+    glfwSetCursorPosCallback(window, cursor_position_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetWindowRefreshCallback(window, window_refresh_callback);
+    
+    // 退出时报告重画次数和进程占用的 CPU 时间，静止时应接近 0%
+    unsigned long frames = 0;
+    double start_time = glfwGetTime();
+    std::clock_t start_clock = std::clock();
     while (!glfwWindowShouldClose(window))
     {
-        if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS)
-            drawing = !drawing;
-        
-        draw_fixed();
-        
-        if (drawing)
+        bool animating = drawing && !finished;
+        if (dirty || animating)
         {
-            if (current_t <= 1.0)
+            dirty = false;
+            double now = glfwGetTime();
+            double elapsed = now - last_time;
+            last_time = now;
+            
+            draw_fixed();
+            
+            if (animating)
             {
-                current_t += 0.001;
-                draw_process(main_nodes, current_t);
+                arc_length.update(main_nodes);
+                draw_process(main_nodes, arc_length.parameterAt(distance));
+                // 最后一帧正好画在终点
+                finished = distance >= arc_length.length();
+                distance = std::min(distance + arc_length.length() / ANIMATION_SECONDS * elapsed, arc_length.length());
             }
-            glfwSetCursorPosCallback(window, NULL);
-            glfwSetMouseButtonCallback(window, NULL);
+            batch->flush();
+            
+            glfwSwapBuffers(window);
+            ++frames;
         }
+        // 动画进行时不等待，帧率由垂直同步限制
+        if (drawing && !finished)
+            glfwPollEvents();
         else
-        {
-            bezier_points.clear();
-            current_t = 0.0;
-            glfwSetCursorPosCallback(window, cursor_position_callback);
-            glfwSetMouseButtonCallback(window, mouse_button_callback);
-        }
-        
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+            glfwWaitEventsTimeout(IDLE_TIMEOUT);
     }
+    double seconds = glfwGetTime() - start_time;
+    double cpu_seconds = (double) (std::clock() - start_clock) / CLOCKS_PER_SEC;
+    std::cout << frames << " frames in " << seconds << " s, CPU " << 100.0 * cpu_seconds / seconds << "%" << std::endl;
     
+    delete batch;
     glfwTerminate();
     return 0;
 }